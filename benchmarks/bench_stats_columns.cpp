@@ -0,0 +1,115 @@
+#include "../include/StatsColumns.h"
+#include "../include/MarketDataStatsTracker.h"
+#include "../include/SymbolStats.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Times the end-of-interval derived metrics pass (VWAP, range, VWAP deviation) over every symbol,
+// from the old unordered_map<string, SymbolStats> store, from a StatsSnapshot, and from StatsColumns
+// with the scalar and the vectorized loop (AVX2 when the CPU has it).
+//
+// Usage: bench_stats_columns [symbols] [rounds]
+
+using namespace std;
+
+struct Derived {
+    vector<double> averagePrice;
+    vector<double> range;
+    vector<double> vwapDeviation;
+
+    explicit Derived(size_t count): averagePrice(count), range(count), vwapDeviation(count) {}
+};
+
+static double derive(const SymbolStats& stats, Derived& out, size_t i) {
+    const double average = stats.getAveragePrice();
+    out.averagePrice[i] = average;
+    out.range[i] = stats.tradeCount > 0? stats.highPrice.toDouble() - stats.lowPrice.toDouble() : 0.0;
+    out.vwapDeviation[i] = average > 0.0? (stats.lastPrice.toDouble() - average) / average : 0.0;
+    return out.vwapDeviation[i];
+}
+
+// Nanoseconds per symbol for one pass, best of rounds so a stray interruption does not count
+static double timePerSymbol(size_t symbols, int rounds, const function<double()>& pass) {
+    volatile double sink = 0.0;
+    double best = 1e300;
+    for (int round = 0; round < rounds; ++round) {
+        const auto start = chrono::steady_clock::now();
+        sink = sink + pass();
+        const double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        if (ns < best) best = ns;
+    }
+    return best / static_cast<double>(symbols);
+}
+
+static void report(const string& name, double nsPerSymbol) {
+    cout << left << setw(36) << name << right << setw(12) << fixed << setprecision(2) << nsPerSymbol << "\n";
+}
+
+int main(int argc, char** argv) {
+    const size_t symbols = argc > 1? stoul(argv[1]) : 5000;
+    const int rounds = argc > 2? stoi(argv[2]) : 200;
+
+    MarketDataStatsTracker tracker;
+    unordered_map<string, SymbolStats> map;
+    mt19937 rng(1);
+    uniform_real_distribution<double> price(5.0, 500.0);
+    uniform_int_distribution<int> quantity(1, 1000);
+
+    for (size_t i = 0; i < symbols; ++i) {
+        const string name = "BENCH" + to_string(i);
+        for (int trade = 0; trade < 4; ++trade) {
+            const MarketDataMessage message{ name, OrderSide::BUY, price(rng), quantity(rng), chrono::system_clock::now() };
+            tracker.update(message);
+            map[name].update(message);
+        }
+    }
+
+    auto snapshot = tracker.snapshot();
+    auto columns = StatsColumns::fromSnapshot(*snapshot);
+    columns.computeDerived();
+
+    cout << "symbols=" << symbols << " rounds=" << rounds << " avx2=" << (StatsColumns::vectorized()? "on" : "off") << "\n";
+    cout << left << setw(36) << "pass" << right << setw(12) << "ns/symbol" << "\n";
+
+    // Outputs are allocated up front for every pass, only the loops are timed
+    Derived out(symbols);
+
+    report("unordered_map<string, SymbolStats>", timePerSymbol(symbols, rounds, [&] {
+        size_t i = 0;
+        double last = 0.0;
+        for (const auto& [name, stats] : map) last = derive(stats, out, i++);
+        return last;
+    }));
+
+    report("StatsSnapshot", timePerSymbol(symbols, rounds, [&] {
+        double last = 0.0;
+        for (size_t i = 0; i < snapshot->symbols.size(); ++i) last = derive(snapshot->symbols[i].second, out, i);
+        return last;
+    }));
+
+    report("StatsColumns scalar", timePerSymbol(symbols, rounds, [&] {
+        columns.computeDerivedScalar();
+        return columns.vwapDeviation.back();
+    }));
+
+    report(StatsColumns::vectorized()? "StatsColumns AVX2" : "StatsColumns (no AVX2 on this CPU)", timePerSymbol(symbols, rounds, [&] {
+        columns.computeDerived();
+        return columns.vwapDeviation.back();
+    }));
+
+    // What it costs to get the columns in the first place
+    report("snapshot() + fromSnapshot", timePerSymbol(symbols, rounds, [&] {
+        tracker.update(MarketDataMessage{ "BENCH0", OrderSide::BUY, 100.0, 1, chrono::system_clock::now() }); // defeat the snapshot cache
+        return static_cast<double>(StatsColumns::fromSnapshot(*tracker.snapshot()).size());
+    }));
+
+    return 0;
+}
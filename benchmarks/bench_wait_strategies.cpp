@@ -0,0 +1,114 @@
+#include "../include/WaitStrategy.h"
+#include "../include/ThreadSafeMessageQueue.h"
+#include "../include/SpscRingBuffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Measures producer -> consumer handoff latency for each WaitStrategy. The producer paces its
+// pushes so the consumer goes idle between messages, which is where the strategies differ.
+//
+// Usage: bench_wait_strategies [messages] [gap_us]
+
+using namespace std;
+
+struct Handoff {
+    int64_t sentNs = 0;
+};
+
+static int64_t nowNs() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double threadCpuSeconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+}
+
+struct RunResult {
+    vector<int64_t> latencies;
+    double consumerCpuSeconds = 0.0;
+    double wallSeconds = 0.0;
+};
+
+static RunResult runOnce(MessageQueue<Handoff>& queue, const WaitStrategy& strategy, size_t messages, chrono::microseconds gap) {
+    RunResult result;
+    result.latencies.reserve(messages);
+    atomic<bool> running{true};
+
+    thread consumer([&]() {
+        const double cpuStart = threadCpuSeconds();
+        Handoff item;
+        while (running || !queue.empty()) {
+            if (strategy.waitPop(queue, item)) result.latencies.push_back(nowNs() - item.sentNs);
+        }
+        result.consumerCpuSeconds = threadCpuSeconds() - cpuStart;
+    });
+
+    const auto wallStart = chrono::steady_clock::now();
+    for (size_t i = 0; i < messages; ++i) {
+        const auto next = chrono::steady_clock::now() + gap;
+        queue.push(Handoff{ nowNs() });
+        while (chrono::steady_clock::now() < next) cpuRelax();
+    }
+
+    running = false;
+    queue.close();
+    consumer.join();
+    result.wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+    return result;
+}
+
+static int64_t percentile(const vector<int64_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+static void report(const string& strategyName, const string& queueName, RunResult result) {
+    sort(result.latencies.begin(), result.latencies.end());
+    cout << left << setw(12) << strategyName
+         << setw(24) << queueName
+         << right << setw(10) << percentile(result.latencies, 0.50)
+         << setw(10) << percentile(result.latencies, 0.99)
+         << setw(12) << percentile(result.latencies, 0.999)
+         << setw(12) << (result.latencies.empty()? 0 : result.latencies.back())
+         << setw(10) << fixed << setprecision(1) << (100.0 * result.consumerCpuSeconds / result.wallSeconds)
+         << "\n";
+}
+
+int main(int argc, char** argv) {
+    const size_t messages = argc > 1? stoul(argv[1]) : 20000;
+    const chrono::microseconds gap(argc > 2? stol(argv[2]) : 50);
+
+    const vector<pair<string, WaitStrategy>> strategies = {
+        { "BUSY_SPIN",  WaitStrategy::busySpin() },
+        { "SPIN_YIELD", WaitStrategy::spinYield() },
+        { "SPIN_PARK",  WaitStrategy::spinPark() },
+    };
+
+    cout << "messages=" << messages << " gap=" << gap.count() << "us, latencies in ns\n";
+    cout << left << setw(12) << "strategy" << setw(24) << "queue"
+         << right << setw(10) << "p50" << setw(10) << "p99" << setw(12) << "p99.9" << setw(12) << "max"
+         << setw(10) << "cpu%" << "\n";
+
+    for (const auto& [name, strategy] : strategies) {
+        ThreadSafeMessageQueue<Handoff> lockedQueue;
+        report(name, "ThreadSafeMessageQueue", runOnce(lockedQueue, strategy, messages, gap));
+
+        SpscRingBuffer<Handoff> ringBuffer(1024);
+        report(name, "SpscRingBuffer", runOnce(ringBuffer, strategy, messages, gap));
+    }
+
+    return 0;
+}
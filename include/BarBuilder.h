@@ -0,0 +1,157 @@
+#pragma once
+
+#include "MarketDataMessage.h"
+#include "MarketDataSubscriber.h"
+#include "MetricsRegistry.h"
+#include "Price.h"
+#include "Symbol.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+enum class BarType {
+    TIME,   // closes on fixed clock boundaries, size is the interval in milliseconds
+    TICK,   // closes after size trades
+    VOLUME  // closes once size shares have traded, the closing trade is never split
+};
+
+inline std::string to_string(BarType type) {
+    switch (type) {
+        case BarType::TIME: return "TIME";
+        case BarType::TICK: return "TICK";
+        case BarType::VOLUME: return "VOLUME";
+        default: return "UNKNOWN";
+    }
+}
+
+struct BarSpec {
+    std::string name;   // key used by getBars, e.g. "1m" or "100t"
+    BarType type;
+    int64_t size;
+
+    static BarSpec time(const std::string& name, std::chrono::milliseconds interval) { return { name, BarType::TIME, interval.count() }; }
+    static BarSpec ticks(const std::string& name, int64_t trades) { return { name, BarType::TICK, trades }; }
+    static BarSpec volume(const std::string& name, int64_t shares) { return { name, BarType::VOLUME, shares }; }
+};
+
+inline std::vector<BarSpec> defaultBarSpecs() {
+    using namespace std::chrono_literals;
+    return { BarSpec::time("1s", 1s), BarSpec::time("1m", 60s), BarSpec::time("5m", 300s) };
+}
+
+struct Bar {
+    Symbol symbol;
+    uint32_t spec = 0;  // index into BarBuilder::getSpecs()
+    std::chrono::system_clock::time_point openTime;  // interval start for time bars, first trade otherwise
+    std::chrono::system_clock::time_point closeTime; // interval end for time bars, last trade otherwise
+    Price open;
+    Price high = Price::min();
+    Price low = Price::max();
+    Price close;
+    uint64_t volume = 0;
+    uint64_t tradeCount = 0;
+    NotionalAccumulator notional = 0; // sum of price * quantity in raw Price units
+
+    // Rounds like SymbolStats::getAveragePrice, within a few ulps
+    double getVwap() const {
+        return volume > 0? static_cast<double>(notional) / (static_cast<double>(volume) * Price::SCALE) : 0.00;
+    }
+};
+
+class IBarSubscriber {
+public:
+    virtual void onBar(const Bar& bar, const BarSpec& spec) = 0;
+    virtual ~IBarSubscriber() = default;
+};
+
+struct BarBuilderConfig {
+    std::vector<BarSpec> specs = defaultBarSpecs();
+    size_t history = 128;  // closed bars kept per symbol and spec, the oldest are overwritten; allocated
+                           // on a symbol's first trade, history * specs * sizeof(Bar) bytes (36 KB by default)
+};
+
+// Subscriber that folds trades into OHLCV bars for every configured spec. Closed bars go into a
+// fixed ring per symbol and spec, allocated when the symbol is first seen, and are published to
+// bar subscribers after the symbol's lock is released, so they may read history from onBar.
+// Time bars are keyed by message timestamp and close when a later trade crosses the boundary,
+// or on closeElapsed() for symbols that stopped trading.
+class BarBuilder : public IMarketDataSubscriber {
+public:
+    static constexpr size_t MAX_SPECS = 16;
+
+private:
+    struct Series {
+        std::vector<Bar> ring;  // preallocated to history
+        size_t next = 0;        // slot the next closed bar goes into
+        size_t closed = 0;      // bars closed so far, the ring holds the newest min(closed, history)
+        Bar current;
+        bool open = false;
+    };
+
+    struct SymbolBars {
+        std::mutex mutex;
+        std::vector<Series> series; // one per spec
+    };
+
+    // Bars closed by one trade, copied out under the symbol's lock. Slots stay unconstructed until
+    // a bar closes, most trades close none and should not pay for MAX_SPECS default Bars.
+    struct ClosedBars {
+        union Slot {
+            Slot() {}
+            Bar bar;
+        };
+        static_assert(std::is_trivially_destructible_v<Bar>, "closed bar slots are never destroyed");
+
+        Slot slots[MAX_SPECS];
+        size_t count = 0;
+
+        void add(const Bar& bar) { new (&slots[count++].bar) Bar(bar); }
+        const Bar& operator[](size_t i) const { return slots[i].bar; }
+    };
+
+    const std::vector<BarSpec> specs_;
+    const size_t history_;
+    std::vector<Counter*> barsClosed_; // per spec
+
+    mutable std::shared_mutex symbolsMutex_; // guards the map, each symbol has its own lock for its bars
+    std::unordered_map<SymbolId, std::unique_ptr<SymbolBars>> symbols_;
+
+    std::shared_ptr<const std::vector<std::shared_ptr<IBarSubscriber>>> subscribers_; // copy on write
+    std::mutex subscribersMutex_;
+
+    SymbolBars& barsFor(Symbol symbol);
+    SymbolBars* findBars(const std::string& symbol) const;
+    std::optional<size_t> findSpec(const std::string& name) const;
+    void closeBar(Series& series, ClosedBars& closed);
+    void publish(const ClosedBars& closed);
+
+public:
+    explicit BarBuilder(const BarBuilderConfig& config = BarBuilderConfig());
+
+    //prevent copying and moving
+    BarBuilder(const BarBuilder&) = delete;
+    BarBuilder& operator=(const BarBuilder&) = delete;
+
+    void onMarketData(const MarketDataMessage& message) override;
+
+    // Closes time bars whose interval ended at or before asOf, call periodically so quiet symbols still emit
+    void closeElapsed(std::chrono::system_clock::time_point asOf = std::chrono::system_clock::now());
+
+    void subscribe(std::shared_ptr<IBarSubscriber> subscriber);
+    void unsubscribe(const std::shared_ptr<IBarSubscriber>& subscriber);
+
+    // Up to count closed bars, oldest first; empty for an unknown spec or symbol
+    std::vector<Bar> getBars(const std::string& symbol, const std::string& spec, size_t count = SIZE_MAX) const;
+    std::optional<Bar> getCurrentBar(const std::string& symbol, const std::string& spec) const;
+
+    const std::vector<BarSpec>& getSpecs() const { return specs_; }
+};
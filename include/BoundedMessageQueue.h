@@ -0,0 +1,266 @@
+#pragma once
+
+#include "MessageQueue.h"
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+enum class OverflowPolicy {
+    BLOCK,          // producer waits for a free slot
+    DROP_NEWEST,    // incoming item is discarded
+    DROP_OLDEST,    // oldest queued item is evicted to make room
+    CONFLATE        // incoming item replaces (or is merged into) a queued item with the same key, otherwise it is dropped when full
+};
+
+struct QueueDropCounters {
+    uint64_t pushed = 0;
+    uint64_t droppedNewest = 0;
+    uint64_t droppedOldest = 0;
+    uint64_t conflated = 0;
+    uint64_t highWatermark = 0;
+
+    uint64_t totalDropped() const {
+        return droppedNewest + droppedOldest + conflated;
+    }
+};
+
+// Fixed capacity multi-producer/multi-consumer queue. Slots are preallocated up front so
+// steady state pushes and pops never touch the allocator.
+template <typename T, typename Key = std::string>
+class BoundedMessageQueue : public MessageQueue<T> {
+public:
+    using KeyFunction = std::function<Key(const T&)>;
+    using MergeFunction = std::function<void(T& pending, const T& incoming)>;
+
+private:
+    std::vector<T> slots_;
+    const size_t capacity_;
+    const OverflowPolicy policy_;
+    KeyFunction keyOf_;
+    MergeFunction mergeInto_; // CONFLATE only, replaces the pending item when unset
+
+    // head_/tail_ are monotonically increasing sequence numbers, slot index is seq % capacity_
+    uint64_t head_ = 0;
+    uint64_t tail_ = 0;
+    std::unordered_map<Key, uint64_t> pendingByKey_; // only used by CONFLATE
+
+    mutable std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+
+    std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> droppedNewest_{0};
+    std::atomic<uint64_t> droppedOldest_{0};
+    std::atomic<uint64_t> conflated_{0};
+    std::atomic<uint64_t> highWatermark_{0};
+
+    size_t count() const { return static_cast<size_t>(tail_ - head_); }
+
+    // Caller must hold mutex_ and ensure the queue is not empty
+    T takeFront() {
+        T& slot = slots_[head_ % capacity_];
+        if (policy_ == OverflowPolicy::CONFLATE) {
+            auto it = pendingByKey_.find(keyOf_(slot));
+            if (it != pendingByKey_.end() && it->second == head_) pendingByKey_.erase(it);
+        }
+        T item = std::move(slot);
+        ++head_;
+        return item;
+    }
+
+    // Returns true if the item was enqueued and a consumer should be notified
+    template <typename U>
+    bool pushImpl(U&& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return enqueueLocked(lock, std::forward<U>(item));
+    }
+
+    // Caller must hold mutex_ through lock, BLOCK may release it while waiting for space
+    template <typename U>
+    bool enqueueLocked(std::unique_lock<std::mutex>& lock, U&& item) {
+        if (policy_ == OverflowPolicy::CONFLATE) {
+            Key key = keyOf_(item);
+            auto it = pendingByKey_.find(key);
+            if (it != pendingByKey_.end()) {
+                if (mergeInto_) mergeInto_(slots_[it->second % capacity_], item);
+                else slots_[it->second % capacity_] = std::forward<U>(item);
+                conflated_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (count() == capacity_) {
+                droppedNewest_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            pendingByKey_.emplace(std::move(key), tail_);
+        }
+        else if (count() == capacity_) {
+            switch (policy_) {
+                case OverflowPolicy::BLOCK:
+                    // Earlier items of a pushBatch are not announced yet, so wake consumers before waiting on them.
+                    // A closed queue has no consumer to wait for, so the item is dropped instead
+                    notEmpty_.notify_all();
+                    notFull_.wait(lock, [this] { return count() < capacity_ || this->closed_.load(std::memory_order_relaxed); });
+                    if (count() == capacity_) {
+                        droppedNewest_.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                    break;
+                case OverflowPolicy::DROP_NEWEST:
+                    droppedNewest_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                case OverflowPolicy::DROP_OLDEST:
+                    takeFront();
+                    droppedOldest_.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        slots_[tail_ % capacity_] = std::forward<U>(item);
+        ++tail_;
+        pushed_.fetch_add(1, std::memory_order_relaxed);
+        if (count() > highWatermark_.load(std::memory_order_relaxed)) highWatermark_.store(count(), std::memory_order_relaxed);
+        return true;
+    }
+
+public:
+    explicit BoundedMessageQueue(
+        size_t capacity,
+        OverflowPolicy policy = OverflowPolicy::BLOCK,
+        KeyFunction keyOf = nullptr,
+        MergeFunction mergeInto = nullptr
+    ):
+        slots_(capacity),
+        capacity_(capacity),
+        policy_(policy),
+        keyOf_(std::move(keyOf)),
+        mergeInto_(std::move(mergeInto))
+        {
+            if (capacity == 0) throw std::invalid_argument("Queue capacity must be greater than zero");
+            if (policy_ == OverflowPolicy::CONFLATE && !keyOf_) throw std::invalid_argument("Conflating queue requires a key function");
+            if (policy_ == OverflowPolicy::CONFLATE) pendingByKey_.reserve(capacity);
+        }
+
+    ~BoundedMessageQueue() override = default;
+
+    //prevent copying and moving
+    BoundedMessageQueue(const BoundedMessageQueue&) = delete;
+    BoundedMessageQueue& operator=(const BoundedMessageQueue&) = delete;
+    BoundedMessageQueue(BoundedMessageQueue&&) = delete;
+    BoundedMessageQueue& operator=(BoundedMessageQueue&&) = delete;
+
+    //functions
+    void push(const T& item) override {
+        if (pushImpl(item)) notEmpty_.notify_one();
+    }
+
+    void push(T&& item) override {
+        if (pushImpl(std::move(item))) notEmpty_.notify_one();
+    }
+
+    void pushBatch(Span<const T> items) override {
+        bool enqueued = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (const auto& item : items) enqueued |= enqueueLocked(lock, item);
+        }
+        if (enqueued) notEmpty_.notify_all();
+    }
+
+    T pop() {
+        T item;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            notEmpty_.wait(lock, [this] { return count() > 0; });
+            item = takeFront();
+        }
+        notFull_.notify_one();
+        return item;
+    }
+
+    bool tryPop(T& item) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (count() == 0) return false;
+            item = takeFront();
+        }
+        notFull_.notify_one();
+        return true;
+    }
+
+    bool waitPop(T& item, std::chrono::nanoseconds timeout) override {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            notEmpty_.wait_for(lock, timeout, [this] { return count() > 0 || this->closed_.load(std::memory_order_relaxed); });
+            if (count() == 0) return false;
+            item = takeFront();
+        }
+        notFull_.notify_one();
+        return true;
+    }
+
+    void close() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            this->closed_.store(true, std::memory_order_release);
+        }
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+    }
+
+    void reopen() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        this->closed_.store(false, std::memory_order_release);
+    }
+
+    size_t drainTo(std::vector<T>& out, size_t maxItems) override {
+        size_t drained = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            while (drained < maxItems && count() > 0) {
+                out.emplace_back(takeFront());
+                ++drained;
+            }
+        }
+        if (drained > 0) notFull_.notify_all();
+        return drained;
+    }
+
+    bool empty() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count() == 0;
+    }
+
+    size_t size() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count();
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    OverflowPolicy policy() const {
+        return policy_;
+    }
+
+    QueueDropCounters getCounters() const {
+        QueueDropCounters counters;
+        counters.pushed = pushed_.load(std::memory_order_relaxed);
+        counters.droppedNewest = droppedNewest_.load(std::memory_order_relaxed);
+        counters.droppedOldest = droppedOldest_.load(std::memory_order_relaxed);
+        counters.conflated = conflated_.load(std::memory_order_relaxed);
+        counters.highWatermark = highWatermark_.load(std::memory_order_relaxed);
+        return counters;
+    }
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Monotonic timestamp used for latency stamps on messages, 0 is reserved for "not stamped"
+inline int64_t latencyClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Lock-free log-linear (HDR style) histogram of nanosecond latencies. Values below 64 ns get exact
+// buckets, above that every power of two is split into 32 linear sub-buckets, so any recorded
+// value is reported within ~3%. record() is a couple of relaxed atomic adds and safe from any thread.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 6;
+    static constexpr int64_t MAX_TRACKABLE_NS = (int64_t(1) << 40) - 1; // ~18 minutes, larger values are clamped
+
+private:
+    static constexpr size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+    static constexpr size_t BUCKET_COUNT = (40 - SUB_BUCKET_BITS) * SUB_BUCKET_HALF + SUB_BUCKET_COUNT;
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> counts_{};
+    std::atomic<uint64_t> totalCount_{0};
+    std::atomic<uint64_t> totalNs_{0};
+    std::atomic<int64_t> maxNs_{0};
+
+    static size_t bucketFor(uint64_t value) {
+        if (value < SUB_BUCKET_COUNT) return static_cast<size_t>(value);
+        const int exponent = 63 - __builtin_clzll(value);
+        const int shift = exponent - SUB_BUCKET_BITS + 1;
+        return static_cast<size_t>(shift) * SUB_BUCKET_HALF + static_cast<size_t>(value >> shift);
+    }
+
+    // Largest value that lands in the bucket
+    static int64_t bucketUpperBound(size_t bucket) {
+        if (bucket < SUB_BUCKET_COUNT) return static_cast<int64_t>(bucket);
+        const size_t shift = bucket / SUB_BUCKET_HALF - 1;
+        const uint64_t subBucket = bucket % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+        return static_cast<int64_t>(((subBucket + 1) << shift) - 1);
+    }
+
+public:
+    void record(int64_t nanos) {
+        if (nanos < 0) nanos = 0;
+        if (nanos > MAX_TRACKABLE_NS) nanos = MAX_TRACKABLE_NS;
+
+        counts_[bucketFor(static_cast<uint64_t>(nanos))].fetch_add(1, std::memory_order_relaxed);
+        totalCount_.fetch_add(1, std::memory_order_relaxed);
+        totalNs_.fetch_add(static_cast<uint64_t>(nanos), std::memory_order_relaxed);
+
+        int64_t currentMax = maxNs_.load(std::memory_order_relaxed);
+        while (nanos > currentMax && !maxNs_.compare_exchange_weak(currentMax, nanos, std::memory_order_relaxed)) {}
+    }
+
+    uint64_t count() const { return totalCount_.load(std::memory_order_relaxed); }
+    int64_t max() const { return maxNs_.load(std::memory_order_relaxed); }
+
+    double mean() const {
+        const uint64_t n = count();
+        return n == 0 ? 0.0 : static_cast<double>(totalNs_.load(std::memory_order_relaxed)) / static_cast<double>(n);
+    }
+
+    // Value at the given quantile in [0, 1], 0 when nothing has been recorded. Concurrent records
+    // may or may not be included, the result is never above the observed max.
+    int64_t percentile(double quantile) const {
+        uint64_t total = 0;
+        for (const auto& bucket : counts_) total += bucket.load(std::memory_order_relaxed);
+        if (total == 0) return 0;
+
+        if (quantile < 0.0) quantile = 0.0;
+        if (quantile > 1.0) quantile = 1.0;
+        uint64_t target = static_cast<uint64_t>(quantile * static_cast<double>(total) + 0.5);
+        if (target == 0) target = 1;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen >= target) {
+                const int64_t upper = bucketUpperBound(i);
+                const int64_t observedMax = max();
+                return upper < observedMax ? upper : observedMax;
+            }
+        }
+        return max();
+    }
+
+    // Not atomic with respect to concurrent record() calls, meant for test setup and operator resets
+    void reset() {
+        for (auto& bucket : counts_) bucket.store(0, std::memory_order_relaxed);
+        totalCount_.store(0, std::memory_order_relaxed);
+        totalNs_.store(0, std::memory_order_relaxed);
+        maxNs_.store(0, std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "LatencyHistogram.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Pipeline stages a message passes through, each measured from the stamps carried on the message
+enum class LatencyStage {
+    PARSE,          // frame received -> pushed onto the ingress queue
+    QUEUE,          // pushed onto the ingress queue -> taken off by a dispatcher (includes shard routing)
+    DISPATCH,       // taken off by a dispatcher -> subscriber callback returned
+    END_TO_END      // frame received -> subscriber callback returned
+};
+
+inline std::string to_string(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::PARSE:      return "parse";
+        case LatencyStage::QUEUE:      return "queue";
+        case LatencyStage::DISPATCH:   return "dispatch";
+        case LatencyStage::END_TO_END: return "end_to_end";
+    }
+    return "unknown";
+}
+
+struct LatencySummary {
+    uint64_t count = 0;
+    int64_t p50Ns = 0;
+    int64_t p99Ns = 0;
+    int64_t p999Ns = 0;
+    int64_t maxNs = 0;
+    double meanNs = 0.0;
+};
+
+// One histogram per stage, written by producers and dispatchers without locks
+class LatencyTracker {
+public:
+    static constexpr size_t STAGE_COUNT = static_cast<size_t>(LatencyStage::END_TO_END) + 1;
+
+private:
+    std::array<LatencyHistogram, STAGE_COUNT> histograms_;
+
+public:
+    LatencyTracker() = default;
+
+    //prevent copying and moving
+    LatencyTracker(const LatencyTracker&) = delete;
+    LatencyTracker& operator=(const LatencyTracker&) = delete;
+
+    void record(LatencyStage stage, int64_t nanos) {
+        histograms_[static_cast<size_t>(stage)].record(nanos);
+    }
+
+    // Records end - start, skipped when the start stamp was never set
+    void recordSpan(LatencyStage stage, int64_t startNs, int64_t endNs) {
+        if (startNs != 0) record(stage, endNs - startNs);
+    }
+
+    const LatencyHistogram& getHistogram(LatencyStage stage) const {
+        return histograms_[static_cast<size_t>(stage)];
+    }
+
+    LatencySummary getSummary(LatencyStage stage) const {
+        const LatencyHistogram& histogram = getHistogram(stage);
+        return LatencySummary{
+            .count = histogram.count(),
+            .p50Ns = histogram.percentile(0.50),
+            .p99Ns = histogram.percentile(0.99),
+            .p999Ns = histogram.percentile(0.999),
+            .maxNs = histogram.max(),
+            .meanNs = histogram.mean()
+        };
+    }
+
+    void reset() {
+        for (auto& histogram : histograms_) histogram.reset();
+    }
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Symbol.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct LeaderboardEntry {
+    Symbol symbol;
+    double value = 0.0;
+};
+
+// Top-K symbols by one metric, maintained as values change. Members sit in an unsorted array with
+// the weakest one tracked, and its value is published as the admission threshold. A member's last
+// offered value is never below the threshold, so an update whose old and new values both fall
+// short can skip the lock: it was not a member and cannot become one. Only would-be leaders lock.
+// This only holds for metrics that never decrease: a shrinking member would stay on the board while
+// symbols rejected earlier stay off, so such metrics must be ranked from a snapshot instead.
+class Leaderboard {
+private:
+    const size_t capacity_;
+
+    mutable std::mutex mutex_;
+    std::vector<LeaderboardEntry> entries_;
+    std::unordered_map<SymbolId, size_t> positions_;
+    size_t weakest_ = 0;
+    std::atomic<double> threshold_{std::numeric_limits<double>::lowest()}; // lowest() until the board is full
+
+    void findWeakest() {
+        weakest_ = 0;
+        for (size_t i = 1; i < entries_.size(); ++i) {
+            if (entries_[i].value < entries_[weakest_].value) weakest_ = i;
+        }
+        if (entries_.size() == capacity_) threshold_.store(entries_[weakest_].value, std::memory_order_relaxed);
+    }
+
+public:
+    explicit Leaderboard(size_t capacity): capacity_(capacity) {
+        entries_.reserve(capacity_);
+        positions_.reserve(capacity_);
+    }
+
+    //prevent copying and moving
+    Leaderboard(const Leaderboard&) = delete;
+    Leaderboard& operator=(const Leaderboard&) = delete;
+
+    // Calls for one symbol must be serialized, previous is the value it last offered (or its initial value)
+    void offer(Symbol symbol, double previous, double current) {
+        if (capacity_ == 0) return;
+        const double threshold = threshold_.load(std::memory_order_relaxed);
+        if (previous < threshold && current < threshold) return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = positions_.find(symbol.id());
+        if (it != positions_.end()) {
+            const size_t index = it->second;
+            entries_[index].value = current;
+            if (index == weakest_ || current < entries_[weakest_].value) findWeakest();
+        } else if (entries_.size() < capacity_) {
+            positions_.emplace(symbol.id(), entries_.size());
+            entries_.push_back({ symbol, current });
+            findWeakest();
+        } else if (current > entries_[weakest_].value) {
+            positions_.erase(entries_[weakest_].symbol.id());
+            positions_.emplace(symbol.id(), weakest_);
+            entries_[weakest_] = { symbol, current };
+            findWeakest();
+        }
+    }
+
+    // Up to n leaders, highest first. Costs O(capacity) whatever the number of tracked symbols.
+    std::vector<LeaderboardEntry> top(size_t n) const {
+        std::vector<LeaderboardEntry> result;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            result = entries_;
+        }
+
+        n = std::min(n, result.size());
+        auto byValue = [](const LeaderboardEntry& lhs, const LeaderboardEntry& rhs) { return lhs.value > rhs.value; };
+        std::partial_sort(result.begin(), result.begin() + n, result.end(), byValue);
+        result.resize(n);
+        return result;
+    }
+
+    size_t capacity() const { return capacity_; }
+};
@@ -1,45 +1,142 @@
 #pragma once
 
+#include "MessageQueue.h"
 #include "ThreadSafeMessageQueue.h"
+#include "SpscRingBuffer.h"
 #include "OrderSide.h"
 #include "MarketDataMessage.h"
 #include "MarketDataSimulator.h"
 #include "MarketDataSubscriber.h"
 #include "MarketDataStatsTracker.h"
 #include "SymbolStats.h"
+#include "WaitStrategy.h"
+#include "SubscriberLane.h"
+#include "LatencyTracker.h"
+#include "MetricsRegistry.h"
 
 
 #include <string>
 #include <vector>
+#include <unordered_set>
 #include <thread>
 #include <chrono>
 #include <atomic>
 #include <optional>
 #include <mutex>
+#include <cstdint>
 #include <memory>
 
+struct MarketDataFeedHandlerConfig {
+    size_t maxBatchSize = 256;          // messages drained per queue lock acquisition
+    WaitStrategy waitStrategy;          // how the dispatcher idles on an empty queue, parks by default
+    size_t shardCount = 1;              // dispatcher workers, every symbol is pinned to one of them
+    size_t shardQueueCapacity = 4096;   // per shard ring buffer, only used when shardCount > 1
+    bool batchDelivery = true;          // hand drained backlogs to wildcard subscribers through onMarketDataBatch
+    bool latencyTracking = true;        // record stage latencies and per-subscriber callback time, one clock read per batch and two per callback
+    MarketDataStatsTrackerConfig stats;  // rolling windows kept by the stats tracker
+};
+
 class MarketDataFeedHandler {
 private:
-    std::shared_ptr<ThreadSafeMessageQueue<MarketDataMessage>> messageQueue_;
+    // What the dispatcher calls, plus the subscriber's callback counters from the metrics registry
+    struct Sink {
+        IMarketDataSubscriber* target;
+        Counter* callbacks;
+        Counter* callbackNanos;
+    };
+
+    struct Subscription {
+        std::shared_ptr<IMarketDataSubscriber> subscriber;
+        std::shared_ptr<SubscriberLane> lane;      // only set for ASYNCHRONOUS and CONFLATED delivery
+        std::unordered_set<std::string> symbols;   // empty means every symbol
+        std::vector<SymbolId> symbolIds;           // symbols interned once at subscribe time
+        std::string metricName;                    // subscriber label of the callback series, removed on unsubscribe
+        std::shared_ptr<Counter> callbacks;        // shared so snapshots still in use keep them valid after removal
+        std::shared_ptr<Counter> callbackNanos;
+
+        Sink sink() const { return Sink{ lane ? lane.get() : subscriber.get(), callbacks.get(), callbackNanos.get() }; }
+        bool wantsAllSymbols() const { return symbols.empty() || symbols.count(SubscriptionOptions::ALL_SYMBOLS) > 0; }
+    };
+
+    // Immutable once published. Wildcard subscribers receive every message, filtered subscribers are
+    // looked up per symbol, so dispatching a message is one hash lookup plus a call per interested subscriber.
+    struct SubscriberList {
+        std::vector<Subscription> subscriptions;
+        std::vector<Sink> allSymbolSinks;
+        std::vector<std::vector<Sink>> filteredSinksBySymbol; // indexed by SymbolId
+        bool hasFilteredSinks = false;
+
+        explicit SubscriberList(std::vector<Subscription> subs = {});
+        const std::vector<Sink>& filteredSinksFor(Symbol symbol) const;
+    };
+
+    // Each dispatcher caches the last snapshot it loaded and only reloads when the version moves
+    struct SubscriberView {
+        std::shared_ptr<const SubscriberList> subscribers;
+        uint64_t version = UINT64_MAX;
+    };
+
+    MarketDataFeedHandlerConfig config_;
+
+    std::shared_ptr<MessageQueue<MarketDataMessage>> messageQueue_;
     std::shared_ptr<MarketDataStatsTracker> statsTracker_;
+    std::shared_ptr<LatencyTracker> latencyTracker_;
+
+    Counter& messagesDispatched_;
+    Gauge& queueDepth_;
+    Gauge& queueDepthHighWatermark_;
+    static std::atomic<uint64_t> subscriptionsCreated_; // numbers unnamed subscribers in /metrics, process wide like the registry
 
-    std::vector<std::shared_ptr<IMarketDataSubscriber>> subscribers_;
-    std::mutex subscriberMutex_;
+    // Copy-on-write subscriber list: writers publish a new immutable snapshot with std::atomic_store
+    // and bump the version, dispatchers keep reading their cached snapshot without taking any lock.
+    std::shared_ptr<const SubscriberList> subscribers_;
+    std::atomic<uint64_t> subscribersVersion_;
+    std::mutex subscriberWriteMutex_; // serializes subscribe/unsubscribe, never taken on the dispatch path
 
-    std::thread dispatcherThread_;
+    // With more than one shard a router thread drains the ingress queue and forwards each message
+    // to its symbol's shard, so per-symbol ordering is preserved while symbols run in parallel.
+    std::vector<std::unique_ptr<SpscRingBuffer<MarketDataMessage>>> shardQueues_;
+    std::vector<size_t> shardBySymbol_; // router thread only, shardFor() cached per SymbolId
+    std::vector<std::thread> dispatcherThreads_;
+    std::thread routerThread_;
     std::atomic<bool> running_;
+    std::atomic<bool> routing_;
 
-    void dispatchLoop();
+    void routeLoop();
+    void dispatchLoop(MessageQueue<MarketDataMessage>& queue);
+    void dispatchBatch(const std::vector<MarketDataMessage>& batch, SubscriberView& view, int64_t dequeuedNs);
+    void recordDelivered(const MarketDataMessage& message, int64_t dequeuedNs, int64_t deliveredNs);
+    int64_t startCallback() const;
+    int64_t finishCallback(const Sink& sink, int64_t startNs);
+    void observeIngressDepth(size_t drained);
+    const SubscriberList& currentSubscribers(SubscriberView& view) const;
+    void publishSubscribers(std::vector<Subscription> subscriptions);
+    void releaseMetrics(const std::string& metricName);
 
 public:
-    explicit MarketDataFeedHandler(std::shared_ptr<ThreadSafeMessageQueue<MarketDataMessage>> messageQueue);
+    explicit MarketDataFeedHandler(
+        std::shared_ptr<MessageQueue<MarketDataMessage>> messageQueue,
+        const MarketDataFeedHandlerConfig& config = MarketDataFeedHandlerConfig()
+    );
     ~MarketDataFeedHandler();
 
     const std::shared_ptr<MarketDataStatsTracker>& getStatsTracker() const;
+    // Per-stage latencies; for asynchronous subscribers DISPATCH ends at the hand-off to their lane
+    const std::shared_ptr<LatencyTracker>& getLatencyTracker() const;
+    size_t getShardCount() const;
+
+    // Stable FNV-1a hash of the symbol, identical across runs and platforms
+    static size_t shardFor(const std::string& symbol, size_t shardCount);
 
     void subscribe(std::shared_ptr<IMarketDataSubscriber> subscriber);
+    void subscribe(std::shared_ptr<IMarketDataSubscriber> subscriber, const SubscriptionOptions& options);
+    // Only messages for the given symbols are delivered, an empty set or ALL_SYMBOLS subscribes to everything
+    void subscribe(std::shared_ptr<IMarketDataSubscriber> subscriber, const std::unordered_set<std::string>& symbols);
     void unsubscribe(std::shared_ptr<IMarketDataSubscriber> subscriber);
 
+    // Lag, depth and drop counters of an asynchronous subscriber, empty for synchronous or unknown subscribers
+    std::optional<SubscriberLaneStats> getLaneStats(const std::shared_ptr<IMarketDataSubscriber>& subscriber) const;
+
     void start();
     void stop();
 };
\ No newline at end of file
@@ -1,13 +1,31 @@
 #pragma once
 
 #include "OrderSide.h"
+#include "Symbol.h"
+#include "Price.h"
+
 #include <string>
 #include <chrono>
+#include <cstdint>
+#include <type_traits>
 
 struct MarketDataMessage {
-    std::string symbol;
+    Symbol symbol;       // interned, compare and hash by id
     OrderSide side;
-    double price;
+    Price price;         // fixed point, exact for decimal inputs
     int quantity;
     std::chrono::system_clock::time_point timestamp;
+    int64_t ingressNs = 0;  // latencyClockNs() when the raw frame arrived, 0 if the source does not stamp
+    int64_t enqueueNs = 0;  // latencyClockNs() when pushed onto the ingress queue
+};
+
+// Queues and lanes copy messages around constantly, keep it a cheap flat copy
+static_assert(std::is_trivially_copyable_v<MarketDataMessage>, "MarketDataMessage must stay trivially copyable");
+static_assert(sizeof(MarketDataMessage) <= 48, "MarketDataMessage should stay well under a cache line");
+
+// Newest message for a symbol plus everything folded into it since the previous delivery
+struct ConflatedMarketData {
+    MarketDataMessage latest;
+    int64_t accumulatedVolume = 0;  // sum of quantities across the conflated messages, latest included
+    uint32_t messageCount = 0;      // how many messages were folded into this update
 };
\ No newline at end of file
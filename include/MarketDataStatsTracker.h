@@ -2,22 +2,178 @@
 
 #include "MarketDataMessage.h"
 #include "SymbolStats.h"
+#include "RollingWindowStats.h"
+#include "QuantileSketch.h"
+#include "Leaderboard.h"
 
-#include <unordered_map>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <mutex>
+#include <optional>
 #include <algorithm>
+#include <chrono>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+enum class LeaderboardMetric {
+    VOLUME,
+    TRADE_COUNT,
+    NOTIONAL,
+    CHANGE      // % change since the first trade, ranked by size so big losers rank alongside big gainers
+};
+
+inline std::string to_string(LeaderboardMetric metric) {
+    switch (metric) {
+        case LeaderboardMetric::VOLUME: return "volume";
+        case LeaderboardMetric::TRADE_COUNT: return "trades";
+        case LeaderboardMetric::NOTIONAL: return "notional";
+        case LeaderboardMetric::CHANGE: return "change";
+        default: return "unknown";
+    }
+}
+
+inline std::optional<LeaderboardMetric> leaderboardMetricFromString(const std::string& name) {
+    if (name == "volume") return LeaderboardMetric::VOLUME;
+    if (name == "trades") return LeaderboardMetric::TRADE_COUNT;
+    if (name == "notional") return LeaderboardMetric::NOTIONAL;
+    if (name == "change") return LeaderboardMetric::CHANGE;
+    return std::nullopt;
+}
+
+struct PriceEwmaSpec {
+    std::string name;                   // key in /stats/<symbol>
+    std::chrono::milliseconds halfLife;
+};
+
+inline std::vector<PriceEwmaSpec> defaultPriceEwmas() {
+    using namespace std::chrono_literals;
+    return { { "1s", 1s }, { "10s", 10s }, { "1m", 60s } };
+}
+
+struct MarketDataStatsTrackerConfig {
+    std::vector<RollingWindowSpec> windows = defaultRollingWindows(); // rolling aggregates kept per symbol
+    bool quantiles = true;                                  // keep price and trade size sketches per symbol
+    QuantileSketchSpec priceSketch = { 0.001, 1024 };       // 0.1%, a window spanning ~7.7x in price
+    QuantileSketchSpec quantitySketch = { 0.01, 512 };      // 1%, a window spanning ~30000x in size
+    std::vector<PriceEwmaSpec> priceEwmas = defaultPriceEwmas(); // at most SymbolStatsParams::MAX_PRICE_EWMAS
+    std::chrono::milliseconds tradeRateHalfLife = std::chrono::seconds(10);
+    std::chrono::milliseconds orderFlowHalfLife = std::chrono::seconds(60); // decay of the order flow imbalance
+    bool tickRule = true;                                   // classify UNKNOWN-side trades (e.g. Finnhub) by the tick rule
+    size_t leaderboardSize = 100;                           // leaders kept per metric, the largest n getLeaders serves; 0 disables
+};
+
+// Distribution of one symbol's trade prices and sizes since it was first seen
+struct SymbolQuantiles {
+    QuantileSketch price;
+    QuantileSketch quantity;
+};
+
+// Stats of every tracked symbol at one point in the update stream, immutable once built
+struct StatsSnapshot {
+    uint64_t version = 0;       // update batches reflected, equal versions mean identical contents
+    bool consistent = true;     // false if updates kept landing mid-read; each symbol is still self-consistent
+    std::chrono::system_clock::time_point takenAt;
+    std::vector<std::pair<Symbol, SymbolStats>> symbols; // in first-seen order
+
+    const SymbolStats* find(const std::string& symbol) const {
+        for (const auto& entry : symbols) {
+            if (entry.first == symbol) return &entry.second;
+        }
+        return nullptr;
+    }
+};
+
+// Per-symbol stats, each behind its own seqlock. Writers never wait on readers and readers never
+// block writers: a read that races an update simply retries. Slots live in fixed-size chunks that
+// are allocated on first sight of a SymbolId and never moved, so readers need no lock to find them.
 class MarketDataStatsTracker {
     private:
-        mutable std::mutex statsMutex_;
-        std::unordered_map<std::string, SymbolStats> stats_;
+        static_assert(std::is_trivially_copyable_v<SymbolStats>, "SymbolStats is copied word by word");
+
+        struct alignas(64) StatsSlot {
+            static constexpr size_t WORDS = (sizeof(SymbolStats) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+            std::atomic<uint32_t> sequence{0};  // odd while an update is in progress
+            std::atomic<uint64_t> words[WORDS]; // SymbolStats bytes, atomics so racing reads are well defined
+            std::atomic<RollingWindows*> windows{nullptr}; // created by the first update, covered by the same sequence
+            std::atomic<SymbolQuantiles*> quantiles{nullptr}; // likewise
+
+            ~StatsSlot() {
+                delete windows.load(std::memory_order_relaxed);
+                delete quantiles.load(std::memory_order_relaxed);
+            }
+
+            void write(const SymbolStats& stats);
+            void readUnsynchronized(SymbolStats& stats) const;
+            bool tryRead(SymbolStats& stats) const;
+        };
+
+        static constexpr size_t CHUNK_BITS = 10;
+        static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+        static constexpr size_t MAX_CHUNKS = SymbolTable::MAX_SYMBOLS / CHUNK_SIZE;
+
+        using Chunk = std::array<StatsSlot, CHUNK_SIZE>;
+
+        static constexpr size_t LEADERBOARD_COUNT = 3; // the metrics that never decrease, CHANGE is ranked on demand
+
+        MarketDataStatsTrackerConfig config_;
+        SymbolStatsParams statsParams_;
+        std::array<std::unique_ptr<Leaderboard>, LEADERBOARD_COUNT> leaderboards_; // indexed by LeaderboardMetric
+        std::array<std::atomic<Chunk*>, MAX_CHUNKS> chunks_{};
+        mutable std::mutex trackedMutex_;       // chunk allocation and trackedSymbols_, once per new symbol
+        std::vector<SymbolId> trackedSymbols_;  // ids with at least one update, in arrival order
+
+        // Every update batch bumps updatesStarted_ before touching a slot and updatesFinished_ after,
+        // so a reader that saw both equal and unchanged across its pass read no partial batch
+        std::atomic<uint64_t> updatesStarted_{0};
+        std::atomic<uint64_t> updatesFinished_{0};
+        mutable std::shared_ptr<const StatsSnapshot> cachedSnapshot_; // std::atomic_load/atomic_store only
+
+        StatsSlot& slotFor(SymbolId id);
+        const StatsSlot* findSlot(SymbolId id) const;
+        void apply(const MarketDataMessage& message, SymbolStats& scratch);
+        void offerLeaders(Symbol symbol, const SymbolStats& before, const SymbolStats& after);
+        void beginUpdate();
+        void endUpdate();
+        bool readAll(StatsSnapshot& snapshot, bool bestEffort) const;
     
     public:
+        explicit MarketDataStatsTracker(const MarketDataStatsTrackerConfig& config = MarketDataStatsTrackerConfig());
+        ~MarketDataStatsTracker();
+
+        //prevent copying and moving
+        MarketDataStatsTracker(const MarketDataStatsTracker&) = delete;
+        MarketDataStatsTracker& operator=(const MarketDataStatsTracker&) = delete;
+
         void update(const MarketDataMessage& message);
+        void update(const std::vector<MarketDataMessage>& messages);
     
-        SymbolStats getStats(const std::string& symbol) const;
+        SymbolStats getStats(const std::string& symbol) const; // does not intern unknown names
+        SymbolStats getStats(SymbolId id) const;
         std::vector<std::string> getAllSymbols() const;
-    };
\ No newline at end of file
+
+        // Aggregates over the named rolling window ending at asOf, nullopt if no such window is configured
+        std::optional<WindowStats> getWindowStats(
+            const std::string& symbol,
+            const std::string& window,
+            std::chrono::system_clock::time_point asOf = std::chrono::system_clock::now()
+        ) const;
+        std::vector<std::string> getWindowNames() const;
+        std::vector<std::string> getPriceEwmaNames() const; // in SymbolStats::priceEwma order
+
+        // Top n symbols by the metric, highest first, n capped at leaderboardSize. Volume, trades and
+        // notional only grow, so their boards are maintained on every update and cost O(leaderboardSize)
+        // to read. A move can shrink, so CHANGE is ranked by absolute size from snapshot(), O(symbols).
+        std::vector<LeaderboardEntry> getLeaders(LeaderboardMetric metric, size_t n) const;
+
+        // Price and trade size sketches of one symbol, empty for an unknown symbol and nullopt if
+        // quantiles are disabled. Sketches merge, e.g. to combine trackers fed by separate shards.
+        std::optional<SymbolQuantiles> getQuantiles(const std::string& symbol) const;
+
+        // All symbols in one pass. Readers share the last snapshot until an update lands, so repeated
+        // calls on a quiet feed cost an atomic load; after an update the first caller builds a new one.
+        std::shared_ptr<const StatsSnapshot> snapshot() const;
+    };
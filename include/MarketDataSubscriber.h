@@ -1,11 +1,25 @@
 #pragma once
 
 #include "MarketDataMessage.h"
+#include "Span.h"
 
 class IMarketDataSubscriber {
 private:
 
 public:
     virtual void onMarketData(const MarketDataMessage& message) = 0;
+
+    // Called with a run of messages when the feed has a backlog. Override to amortize locking,
+    // formatting or I/O over the batch; the default simply forwards each message.
+    virtual void onMarketDataBatch(Span<const MarketDataMessage> messages) {
+        for (const auto& message : messages) onMarketData(message);
+    }
+
+    // Called by conflating subscriptions with the newest state of one symbol. The default forwards
+    // the latest message, subscribers that care about the skipped volume override this.
+    virtual void onConflatedMarketData(const ConflatedMarketData& update) {
+        onMarketData(update.latest);
+    }
+
     virtual ~IMarketDataSubscriber() = default;
-};
\ No newline at end of file
+};
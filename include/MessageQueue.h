@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include <utility>
+
+#include "Span.h"
+
+// Common push/pop surface shared by every queue implementation so the feed handler,
+// data sources and loggers can be instantiated on whichever queue fits their threading model.
+template <typename T>
+class MessageQueue {
+protected:
+    std::atomic<bool> closed_{false};
+
+public:
+    virtual ~MessageQueue() = default;
+
+    virtual void push(const T& item) = 0;
+    virtual void push(T&& item) = 0;
+    virtual bool tryPop(T& item) = 0;
+
+    // Enqueues a run of items. Implementations override this to take their lock once per batch.
+    virtual void pushBatch(Span<const T> items) {
+        for (const auto& item : items) push(item);
+    }
+
+    // Appends up to maxItems queued items to out and returns how many were moved.
+    // Implementations override this to take their lock (or publish their index) once per batch.
+    virtual size_t drainTo(std::vector<T>& out, size_t maxItems) {
+        size_t drained = 0;
+        T item;
+        while (drained < maxItems && tryPop(item)) {
+            out.emplace_back(std::move(item));
+            ++drained;
+        }
+        return drained;
+    }
+
+    std::vector<T> popBatch(size_t maxItems) {
+        std::vector<T> batch;
+        drainTo(batch, maxItems);
+        return batch;
+    }
+
+    // Blocks until an item is available, the timeout expires or the queue is closed.
+    // Returns false without an item on timeout, or once the queue is closed and drained.
+    // The default polls with a short backoff; queues owning a condition variable override it.
+    virtual bool waitPop(T& item, std::chrono::nanoseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::chrono::microseconds backoff(1);
+
+        while (!tryPop(item)) {
+            if (closed_.load(std::memory_order_acquire) || std::chrono::steady_clock::now() >= deadline) return false;
+            std::this_thread::sleep_for(backoff);
+            backoff = std::min(backoff * 2, std::chrono::microseconds(1000));
+        }
+        return true;
+    }
+
+    // Wakes every blocked consumer. Pushes are still accepted so nothing in flight is lost,
+    // consumers simply stop waiting once the remaining items are drained.
+    virtual void close() {
+        closed_.store(true, std::memory_order_release);
+    }
+
+    virtual void reopen() {
+        closed_.store(false, std::memory_order_release);
+    }
+
+    bool isClosed() const {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+    // True for queues that allow only one pushing thread at a time, owners with several producers
+    // must serialize their pushes
+    virtual bool singleProducer() const { return false; }
+
+    virtual bool empty() const = 0;
+    virtual size_t size() const = 0;
+};
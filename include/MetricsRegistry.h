@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Monotonic counter, a relaxed atomic add on the hot path
+class Counter {
+private:
+    std::atomic<uint64_t> value_{0};
+
+public:
+    void increment(uint64_t amount = 1) { value_.fetch_add(amount, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+};
+
+class Gauge {
+private:
+    std::atomic<int64_t> value_{0};
+
+public:
+    void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+    void add(int64_t amount) { value_.fetch_add(amount, std::memory_order_relaxed); }
+
+    // Raises the gauge to value if it is higher, for high watermarks
+    void setMax(int64_t value) {
+        int64_t current = value_.load(std::memory_order_relaxed);
+        while (value > current && !value_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+};
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+// Process wide registry of named counters and gauges, rendered in the Prometheus text exposition
+// format. Registration takes a lock and returns a reference that stays valid for the life of the
+// process, so components look their metrics up once and only touch atomics afterwards. Series tied
+// to something short lived (a subscription) are taken as shared pointers and removed when it ends,
+// counted per holder so two owners of the same label set do not remove each other's series.
+class MetricsRegistry {
+private:
+    enum class MetricType { COUNTER, GAUGE };
+    static constexpr size_t PINNED = SIZE_MAX;
+
+    struct Family {
+        std::string help;
+        MetricType type;
+        double scale = 1.0;
+        std::map<std::string, std::shared_ptr<Counter>> counters; // keyed by rendered label set
+        std::map<std::string, std::shared_ptr<Gauge>> gauges;
+        std::map<std::string, size_t> holders; // sharedCounter() calls not yet matched by a remove()
+    };
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family> families_;
+
+    MetricsRegistry() = default;
+
+    static std::string formatLabels(const MetricLabels& labels) {
+        if (labels.empty()) return "";
+
+        std::string text = "{";
+        for (size_t i = 0; i < labels.size(); ++i) {
+            if (i > 0) text += ",";
+            text += labels[i].first + "=\"";
+            for (char c : labels[i].second) {
+                if (c == '\\' || c == '"') text += '\\';
+                if (c == '\n') { text += "\\n"; continue; }
+                text += c;
+            }
+            text += "\"";
+        }
+        return text + "}";
+    }
+
+    Family& familyFor(const std::string& name, const std::string& help, MetricType type, double scale) {
+        auto [it, inserted] = families_.try_emplace(name);
+        if (inserted) {
+            it->second.help = help;
+            it->second.type = type;
+            it->second.scale = scale;
+        } else if (it->second.type != type) {
+            throw std::invalid_argument("Metric " + name + " is already registered with a different type");
+        }
+        return it->second;
+    }
+
+public:
+    //prevent copying and moving
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    static MetricsRegistry& instance() {
+        static MetricsRegistry registry;
+        return registry;
+    }
+
+    // Returns the existing series when called again with the same name and labels.
+    // scale multiplies the rendered value, e.g. 1e-9 to expose a nanosecond counter as seconds.
+    Counter& counter(const std::string& name, const std::string& help, const MetricLabels& labels = {}, double scale = 1.0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& family = familyFor(name, help, MetricType::COUNTER, scale);
+        const std::string key = formatLabels(labels);
+        auto& series = family.counters[key];
+        if (!series) series = std::make_shared<Counter>();
+        family.holders[key] = PINNED; // a plain reference cannot be taken back
+        return *series;
+    }
+
+    // Same series as counter(), the pointer keeps it usable after remove() takes it out of the registry.
+    // Each call must be matched by one remove(), the series stays registered until the last one.
+    std::shared_ptr<Counter> sharedCounter(const std::string& name, const std::string& help, const MetricLabels& labels = {}, double scale = 1.0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& family = familyFor(name, help, MetricType::COUNTER, scale);
+        const std::string key = formatLabels(labels);
+        auto& series = family.counters[key];
+        if (!series) series = std::make_shared<Counter>();
+        auto& holders = family.holders[key];
+        if (holders != PINNED) ++holders;
+        return series;
+    }
+
+    Gauge& gauge(const std::string& name, const std::string& help, const MetricLabels& labels = {}) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& series = familyFor(name, help, MetricType::GAUGE, 1.0).gauges[formatLabels(labels)];
+        if (!series) series = std::make_shared<Gauge>();
+        return *series;
+    }
+
+    // Releases one sharedCounter() hold on a series. The last release drops it from the registry and
+    // from /metrics, a family left without series goes too. Series also handed out by counter() or
+    // gauge() are never dropped, plain references would dangle.
+    void remove(const std::string& name, const MetricLabels& labels) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = families_.find(name);
+        if (it == families_.end()) return;
+
+        const std::string key = formatLabels(labels);
+        auto holder = it->second.holders.find(key);
+        if (holder == it->second.holders.end()) return;
+        if (holder->second == PINNED || --holder->second > 0) return;
+
+        it->second.holders.erase(holder);
+        it->second.counters.erase(key);
+        it->second.gauges.erase(key);
+        if (it->second.counters.empty() && it->second.gauges.empty()) families_.erase(it);
+    }
+
+    std::string renderPrometheus() const {
+        std::ostringstream out;
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (const auto& [name, family] : families_) {
+            out << "# HELP " << name << " " << family.help << "\n";
+            out << "# TYPE " << name << " " << (family.type == MetricType::COUNTER ? "counter" : "gauge") << "\n";
+
+            for (const auto& [labels, counter] : family.counters) {
+                out << name << labels << " ";
+                if (family.scale == 1.0) out << counter->value();
+                else out << static_cast<double>(counter->value()) * family.scale;
+                out << "\n";
+            }
+            for (const auto& [labels, gauge] : family.gauges) out << name << labels << " " << gauge->value() << "\n";
+        }
+        return out.str();
+    }
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <string_view>
+
+// 128-bit where the compiler has it, so price * quantity sums cannot overflow in practice
+#if defined(__SIZEOF_INT128__)
+using NotionalAccumulator = __int128;
+#else
+using NotionalAccumulator = long double;
+#endif
+
+// Fixed-point price in millionths of a currency unit. Inputs are decimal, so parsing straight into
+// an integer keeps them exact and sums of price * quantity free of floating point rounding.
+// Converts implicitly from and to double so existing arithmetic and formatting keep working;
+// the min()/max() sentinels round-trip to numeric_limits<double>::lowest()/max().
+class Price {
+private:
+    int64_t raw_ = 0;
+
+public:
+    static constexpr int64_t SCALE = 1000000;
+    static constexpr int DECIMALS = 6;
+
+    constexpr Price() = default;
+
+    Price(double value) {
+        if (std::isnan(value)) raw_ = 0;
+        else if (value <= static_cast<double>(std::numeric_limits<int64_t>::min()) / SCALE) raw_ = std::numeric_limits<int64_t>::min();
+        else if (value >= static_cast<double>(std::numeric_limits<int64_t>::max()) / SCALE) raw_ = std::numeric_limits<int64_t>::max();
+        else raw_ = std::llround(value * SCALE);
+    }
+
+    static constexpr Price fromRaw(int64_t raw) {
+        Price price;
+        price.raw_ = raw;
+        return price;
+    }
+
+    static constexpr Price min() { return fromRaw(std::numeric_limits<int64_t>::min()); }
+    static constexpr Price max() { return fromRaw(std::numeric_limits<int64_t>::max()); }
+
+    constexpr int64_t raw() const { return raw_; }
+
+    double toDouble() const {
+        if (raw_ == std::numeric_limits<int64_t>::min()) return std::numeric_limits<double>::lowest();
+        if (raw_ == std::numeric_limits<int64_t>::max()) return std::numeric_limits<double>::max();
+        return static_cast<double>(raw_) / SCALE;
+    }
+
+    operator double() const { return toDouble(); }
+
+    // Parses an optionally signed decimal ("150", "-0.25", "2800.123456") without going through
+    // a double. Digits past the sixth decimal are rounded half away from zero.
+    static std::optional<Price> parse(std::string_view text) {
+        size_t pos = 0;
+        bool negative = false;
+        if (pos < text.size() && (text[pos] == '-' || text[pos] == '+')) negative = text[pos++] == '-';
+
+        constexpr int64_t MAX_WHOLE = std::numeric_limits<int64_t>::max() / SCALE - 1;
+        int64_t whole = 0;
+        size_t wholeDigits = 0;
+        for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos, ++wholeDigits) {
+            whole = whole * 10 + (text[pos] - '0');
+            if (whole > MAX_WHOLE) return std::nullopt;
+        }
+
+        int64_t fraction = 0;
+        size_t fractionDigits = 0;
+        bool roundUp = false;
+        if (pos < text.size() && text[pos] == '.') {
+            for (++pos; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos, ++fractionDigits) {
+                if (fractionDigits < DECIMALS) fraction = fraction * 10 + (text[pos] - '0');
+                else if (fractionDigits == DECIMALS) roundUp = text[pos] >= '5';
+            }
+        }
+
+        if (pos != text.size() || wholeDigits + fractionDigits == 0) return std::nullopt;
+
+        for (size_t i = fractionDigits; i < DECIMALS; ++i) fraction *= 10;
+        int64_t raw = whole * SCALE + fraction + (roundUp ? 1 : 0);
+        return fromRaw(negative ? -raw : raw);
+    }
+
+    friend bool operator==(Price lhs, Price rhs) { return lhs.raw_ == rhs.raw_; }
+    friend bool operator!=(Price lhs, Price rhs) { return lhs.raw_ != rhs.raw_; }
+    friend bool operator<(Price lhs, Price rhs) { return lhs.raw_ < rhs.raw_; }
+    friend bool operator<=(Price lhs, Price rhs) { return lhs.raw_ <= rhs.raw_; }
+    friend bool operator>(Price lhs, Price rhs) { return lhs.raw_ > rhs.raw_; }
+    friend bool operator>=(Price lhs, Price rhs) { return lhs.raw_ >= rhs.raw_; }
+
+    // Mixed comparisons are done in double, otherwise they would be ambiguous with the implicit conversions
+    friend bool operator==(Price lhs, double rhs) { return lhs.toDouble() == rhs; }
+    friend bool operator==(double lhs, Price rhs) { return lhs == rhs.toDouble(); }
+    friend bool operator!=(Price lhs, double rhs) { return lhs.toDouble() != rhs; }
+    friend bool operator!=(double lhs, Price rhs) { return lhs != rhs.toDouble(); }
+    friend bool operator<(Price lhs, double rhs) { return lhs.toDouble() < rhs; }
+    friend bool operator<(double lhs, Price rhs) { return lhs < rhs.toDouble(); }
+    friend bool operator<=(Price lhs, double rhs) { return lhs.toDouble() <= rhs; }
+    friend bool operator<=(double lhs, Price rhs) { return lhs <= rhs.toDouble(); }
+    friend bool operator>(Price lhs, double rhs) { return lhs.toDouble() > rhs; }
+    friend bool operator>(double lhs, Price rhs) { return lhs > rhs.toDouble(); }
+    friend bool operator>=(Price lhs, double rhs) { return lhs.toDouble() >= rhs; }
+    friend bool operator>=(double lhs, Price rhs) { return lhs >= rhs.toDouble(); }
+
+    friend std::ostream& operator<<(std::ostream& os, Price price) { return os << price.toDouble(); }
+};
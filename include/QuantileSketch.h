@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+struct QuantileSketchSpec {
+    double relativeAccuracy;    // every quantile is within this fraction of a value in its rank range
+    size_t buckets;             // memory bound, values spanning more than gamma^buckets collapse the lowest buckets
+};
+
+// Mergeable streaming quantile sketch with relative error guarantees (the DDSketch scheme). A value
+// v lands in bucket ceil(log_gamma(v)), so an update is one counter increment and the memory is a
+// fixed window of buckets that slides to follow the data. Sketches with the same accuracy merge
+// exactly, whatever windows they cover. Non-positive values are counted as zero.
+// Every field is a relaxed atomic so a seqlock owner can copy it while it is written; the owner
+// serializes writers and validates reads, copies and merges are otherwise single threaded.
+class QuantileSketch {
+private:
+    static constexpr double MIN_POSITIVE = 1e-9;
+
+    double relativeAccuracy_;
+    double gamma_;
+    double logGamma_;
+    size_t bucketCount_;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+    std::atomic<int32_t> offset_{0};    // key of buckets_[0]
+    std::atomic<int32_t> minKey_{0};    // lowest and highest occupied keys, valid when a bucket is non-empty
+    std::atomic<int32_t> maxKey_{0};
+    std::atomic<uint64_t> zeroCount_{0};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<double> min_{std::numeric_limits<double>::max()};
+    std::atomic<double> max_{std::numeric_limits<double>::lowest()};
+
+    int32_t keyOf(double value) const {
+        return static_cast<int32_t>(std::ceil(std::log(value) / logGamma_));
+    }
+
+    // Midpoint of the bucket in relative terms, so either edge is within relativeAccuracy of it
+    double valueOf(int32_t key) const {
+        return 2.0 * std::pow(gamma_, key) / (gamma_ + 1.0);
+    }
+
+    uint64_t bucketsCounted() const {
+        return count_.load(std::memory_order_relaxed) - zeroCount_.load(std::memory_order_relaxed);
+    }
+
+    // Moves the window so it starts at newOffset, anything below it folds into the first bucket
+    void rebase(int32_t newOffset) {
+        const int32_t offset = offset_.load(std::memory_order_relaxed);
+        const int32_t lo = minKey_.load(std::memory_order_relaxed);
+        const int32_t hi = maxKey_.load(std::memory_order_relaxed);
+
+        std::unique_ptr<uint64_t[]> moved(new uint64_t[bucketCount_]());
+        for (int32_t key = lo; key <= hi; ++key) {
+            const uint64_t count = buckets_[key - offset].load(std::memory_order_relaxed);
+            moved[std::max(key, newOffset) - newOffset] += count;
+        }
+        for (size_t i = 0; i < bucketCount_; ++i) buckets_[i].store(moved[i], std::memory_order_relaxed);
+
+        offset_.store(newOffset, std::memory_order_relaxed);
+        minKey_.store(std::max(lo, newOffset), std::memory_order_relaxed);
+    }
+
+    // Centers the window on key, for the first bucket a sketch counts
+    void seed(int32_t key) {
+        offset_.store(key - static_cast<int32_t>(bucketCount_) / 2, std::memory_order_relaxed);
+        minKey_.store(key, std::memory_order_relaxed);
+        maxKey_.store(key, std::memory_order_relaxed);
+    }
+
+    // Callers seed() an empty sketch first, count_ is only updated once the keys are added
+    void addKey(int32_t key, uint64_t weight) {
+        const int32_t span = static_cast<int32_t>(bucketCount_);
+        int32_t offset = offset_.load(std::memory_order_relaxed);
+        const int32_t lo = std::min(minKey_.load(std::memory_order_relaxed), key);
+        const int32_t hi = std::max(maxKey_.load(std::memory_order_relaxed), key);
+
+        if (key >= offset + span || (key < offset && hi - lo < span)) {
+            // Recenter when everything fits, otherwise keep the top of the range and collapse the bottom
+            rebase(hi - lo < span ? lo - (span - (hi - lo + 1)) / 2 : hi - span + 1);
+            offset = offset_.load(std::memory_order_relaxed);
+        }
+
+        const int32_t clamped = std::max(key, offset);
+        buckets_[clamped - offset].fetch_add(weight, std::memory_order_relaxed);
+        minKey_.store(std::min(minKey_.load(std::memory_order_relaxed), clamped), std::memory_order_relaxed);
+        maxKey_.store(hi, std::memory_order_relaxed);
+    }
+
+public:
+    explicit QuantileSketch(const QuantileSketchSpec& spec = { 0.01, 512 }):
+        relativeAccuracy_(spec.relativeAccuracy),
+        gamma_((1.0 + spec.relativeAccuracy) / (1.0 - spec.relativeAccuracy)),
+        logGamma_(std::log(gamma_)),
+        bucketCount_(spec.buckets)
+        {
+            if (!(spec.relativeAccuracy > 0.0 && spec.relativeAccuracy < 1.0)) throw std::invalid_argument("Quantile sketch accuracy must be in (0, 1)");
+            if (spec.buckets < 2) throw std::invalid_argument("Quantile sketch needs at least two buckets");
+            buckets_.reset(new std::atomic<uint64_t>[bucketCount_]);
+            clear();
+        }
+
+    QuantileSketch(const QuantileSketch& other):
+        QuantileSketch(QuantileSketchSpec{ other.relativeAccuracy_, other.bucketCount_ })
+        {
+            *this = other;
+        }
+
+    // Reuses this sketch's buckets when the shapes match, so a reader can copy in a retry loop without allocating
+    QuantileSketch& operator=(const QuantileSketch& other) {
+        if (this == &other) return *this;
+        if (bucketCount_ != other.bucketCount_) buckets_.reset(new std::atomic<uint64_t>[other.bucketCount_]);
+        relativeAccuracy_ = other.relativeAccuracy_;
+        gamma_ = other.gamma_;
+        logGamma_ = other.logGamma_;
+        bucketCount_ = other.bucketCount_;
+
+        for (size_t i = 0; i < bucketCount_; ++i) buckets_[i].store(other.buckets_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        offset_.store(other.offset_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        minKey_.store(other.minKey_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        maxKey_.store(other.maxKey_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        zeroCount_.store(other.zeroCount_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        count_.store(other.count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        min_.store(other.min_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        max_.store(other.max_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < bucketCount_; ++i) buckets_[i].store(0, std::memory_order_relaxed);
+        offset_.store(0, std::memory_order_relaxed);
+        minKey_.store(0, std::memory_order_relaxed);
+        maxKey_.store(0, std::memory_order_relaxed);
+        zeroCount_.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        min_.store(std::numeric_limits<double>::max(), std::memory_order_relaxed);
+        max_.store(std::numeric_limits<double>::lowest(), std::memory_order_relaxed);
+    }
+
+    void add(double value, uint64_t weight = 1) {
+        if (weight == 0 || std::isnan(value)) return;
+
+        if (value < MIN_POSITIVE) zeroCount_.fetch_add(weight, std::memory_order_relaxed);
+        else {
+            const int32_t key = keyOf(value);
+            if (bucketsCounted() == 0) seed(key);
+            addKey(key, weight);
+        }
+
+        count_.fetch_add(weight, std::memory_order_relaxed);
+        min_.store(std::min(min_.load(std::memory_order_relaxed), value), std::memory_order_relaxed);
+        max_.store(std::max(max_.load(std::memory_order_relaxed), value), std::memory_order_relaxed);
+    }
+
+    // Adds every value recorded by other, e.g. to combine sketches kept by separate shards
+    void merge(const QuantileSketch& other) {
+        if (other.relativeAccuracy_ != relativeAccuracy_) throw std::invalid_argument("Cannot merge quantile sketches of different accuracy");
+        if (other.count() == 0) return;
+
+        if (other.bucketsCounted() > 0) {
+            const int32_t offset = other.offset_.load(std::memory_order_relaxed);
+            const int32_t lo = other.minKey_.load(std::memory_order_relaxed);
+            const int32_t hi = other.maxKey_.load(std::memory_order_relaxed);
+            if (bucketsCounted() == 0) seed(lo);
+            for (int32_t key = lo; key <= hi; ++key) {
+                const uint64_t count = other.buckets_[key - offset].load(std::memory_order_relaxed);
+                if (count > 0) addKey(key, count);
+            }
+        }
+
+        zeroCount_.fetch_add(other.zeroCount_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        count_.fetch_add(other.count(), std::memory_order_relaxed);
+        min_.store(std::min(min(), other.min()), std::memory_order_relaxed);
+        max_.store(std::max(max(), other.max()), std::memory_order_relaxed);
+    }
+
+    // Value at quantile q in [0, 1], 0 for an empty sketch. Clamped to the exact min and max seen.
+    double quantile(double q) const {
+        const uint64_t total = count();
+        if (total == 0) return 0.00;
+        if (q <= 0.0) return min();
+        if (q >= 1.0) return max();
+
+        const double rank = q * static_cast<double>(total - 1);
+        uint64_t seen = zeroCount_.load(std::memory_order_relaxed);
+        if (rank < static_cast<double>(seen)) return std::max(min(), 0.0);
+
+        if (bucketsCounted() > 0) {
+            const int32_t offset = offset_.load(std::memory_order_relaxed);
+            const int32_t hi = maxKey_.load(std::memory_order_relaxed);
+            for (int32_t key = minKey_.load(std::memory_order_relaxed); key <= hi; ++key) {
+                seen += buckets_[key - offset].load(std::memory_order_relaxed);
+                if (rank < static_cast<double>(seen)) return std::clamp(valueOf(key), min(), max());
+            }
+        }
+        return max();
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    double min() const { return count() ? min_.load(std::memory_order_relaxed) : 0.00; }
+    double max() const { return count() ? max_.load(std::memory_order_relaxed) : 0.00; }
+    double relativeAccuracy() const { return relativeAccuracy_; }
+};
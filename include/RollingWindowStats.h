@@ -0,0 +1,163 @@
+#pragma once
+
+#include "MarketDataMessage.h"
+#include "Price.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct RollingWindowSpec {
+    std::string name;                   // key used by getWindowStats and /stats/<symbol>?window=
+    std::chrono::milliseconds length;
+    size_t buckets;                     // resolution, the window slides forward one bucket at a time
+};
+
+inline std::vector<RollingWindowSpec> defaultRollingWindows() {
+    using namespace std::chrono_literals;
+    return {
+        { "1s", 1000ms, 10 },
+        { "1m", 60s, 60 },
+        { "5m", 300s, 60 },
+        { "1h", 3600s, 60 }
+    };
+}
+
+struct WindowStats {
+    uint64_t totalVolume = 0;
+    uint64_t tradeCount = 0;
+    Price highPrice = Price::min();
+    Price lowPrice = Price::max();
+    NotionalAccumulator totalNotional = 0; // sum of price * quantity in raw Price units
+
+    // Rounds like SymbolStats::getAveragePrice, within a few ulps
+    double getVwap() const {
+        return totalVolume > 0? static_cast<double>(totalNotional) / (static_cast<double>(totalVolume) * Price::SCALE) : 0.00;
+    }
+};
+
+// Fixed ring of time buckets per window for one symbol. Messages land in the bucket of their own
+// timestamp, so an update touches one bucket per window and memory never grows. Every field is a
+// relaxed atomic: the owner serializes writers and readers validate with the symbol's seqlock.
+class RollingWindows {
+private:
+    static constexpr int64_t EMPTY_EPOCH = std::numeric_limits<int64_t>::min();
+    static constexpr size_t NOTIONAL_WORDS = (sizeof(NotionalAccumulator) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Bucket {
+        std::atomic<int64_t> epoch{EMPTY_EPOCH};   // timestamp / bucket width of the data held
+        std::atomic<uint64_t> volume{0};
+        std::atomic<uint64_t> trades{0};
+        std::atomic<int64_t> high{0};
+        std::atomic<int64_t> low{0};
+        std::atomic<uint64_t> notional[NOTIONAL_WORDS] = {};
+    };
+
+    struct Window {
+        int64_t bucketWidthNs;
+        size_t bucketCount;
+        size_t firstBucket;
+    };
+
+    std::vector<Window> windows_;
+    std::unique_ptr<Bucket[]> buckets_;
+
+    static NotionalAccumulator loadNotional(const Bucket& bucket) {
+        uint64_t words[NOTIONAL_WORDS];
+        for (size_t i = 0; i < NOTIONAL_WORDS; ++i) words[i] = bucket.notional[i].load(std::memory_order_relaxed);
+        NotionalAccumulator value;
+        std::memcpy(&value, words, sizeof(value));
+        return value;
+    }
+
+    static void storeNotional(Bucket& bucket, NotionalAccumulator value) {
+        uint64_t words[NOTIONAL_WORDS] = {};
+        std::memcpy(words, &value, sizeof(value));
+        for (size_t i = 0; i < NOTIONAL_WORDS; ++i) bucket.notional[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    static int64_t toNanos(std::chrono::system_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+    // Floor division, so timestamps before the epoch still map to consistent buckets
+    static int64_t epochOf(int64_t nanos, int64_t width) {
+        return nanos >= 0 ? nanos / width : -((-nanos + width - 1) / width);
+    }
+
+public:
+    explicit RollingWindows(const std::vector<RollingWindowSpec>& specs) {
+        size_t total = 0;
+        for (const auto& spec : specs) {
+            if (spec.buckets == 0) throw std::invalid_argument("Rolling window " + spec.name + " needs at least one bucket");
+            const int64_t widthNs = std::chrono::duration_cast<std::chrono::nanoseconds>(spec.length).count() / static_cast<int64_t>(spec.buckets);
+            if (widthNs <= 0) throw std::invalid_argument("Rolling window " + spec.name + " is shorter than its bucket count");
+
+            windows_.push_back(Window{ widthNs, spec.buckets, total });
+            total += spec.buckets;
+        }
+        buckets_ = std::make_unique<Bucket[]>(total);
+    }
+
+    //prevent copying and moving
+    RollingWindows(const RollingWindows&) = delete;
+    RollingWindows& operator=(const RollingWindows&) = delete;
+
+    // Single writer at a time
+    void update(const MarketDataMessage& message) {
+        const int64_t nanos = toNanos(message.timestamp);
+        const int64_t price = message.price.raw();
+
+        for (const auto& window : windows_) {
+            const int64_t epoch = epochOf(nanos, window.bucketWidthNs);
+            const size_t index = static_cast<size_t>(((epoch % static_cast<int64_t>(window.bucketCount)) + window.bucketCount) % window.bucketCount);
+            Bucket& bucket = buckets_[window.firstBucket + index];
+
+            const int64_t held = bucket.epoch.load(std::memory_order_relaxed);
+            if (epoch < held) continue; // older than everything this slot now covers, already out of the window
+
+            if (epoch != held) {
+                bucket.epoch.store(epoch, std::memory_order_relaxed);
+                bucket.volume.store(0, std::memory_order_relaxed);
+                bucket.trades.store(0, std::memory_order_relaxed);
+                bucket.high.store(price, std::memory_order_relaxed);
+                bucket.low.store(price, std::memory_order_relaxed);
+                storeNotional(bucket, 0);
+            }
+
+            bucket.volume.store(bucket.volume.load(std::memory_order_relaxed) + message.quantity, std::memory_order_relaxed);
+            bucket.trades.store(bucket.trades.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            if (price > bucket.high.load(std::memory_order_relaxed)) bucket.high.store(price, std::memory_order_relaxed);
+            if (price < bucket.low.load(std::memory_order_relaxed)) bucket.low.store(price, std::memory_order_relaxed);
+            storeNotional(bucket, loadNotional(bucket) + static_cast<NotionalAccumulator>(price) * message.quantity);
+        }
+    }
+
+    // Aggregates the buckets of one window that end at or before asOf. Not synchronized on its own.
+    WindowStats read(size_t windowIndex, std::chrono::system_clock::time_point asOf) const {
+        const Window& window = windows_[windowIndex];
+        const int64_t newest = epochOf(toNanos(asOf), window.bucketWidthNs);
+        const int64_t oldest = newest - static_cast<int64_t>(window.bucketCount) + 1;
+
+        WindowStats stats;
+        for (size_t i = 0; i < window.bucketCount; ++i) {
+            const Bucket& bucket = buckets_[window.firstBucket + i];
+            const int64_t epoch = bucket.epoch.load(std::memory_order_relaxed);
+            if (epoch < oldest || epoch > newest) continue;
+
+            stats.totalVolume += bucket.volume.load(std::memory_order_relaxed);
+            stats.tradeCount += bucket.trades.load(std::memory_order_relaxed);
+            stats.highPrice = std::max(stats.highPrice, Price::fromRaw(bucket.high.load(std::memory_order_relaxed)));
+            stats.lowPrice = std::min(stats.lowPrice, Price::fromRaw(bucket.low.load(std::memory_order_relaxed)));
+            stats.totalNotional += loadNotional(bucket);
+        }
+        return stats;
+    }
+};
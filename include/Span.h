@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <type_traits>
+
+// Non-owning view over a contiguous range, a C++17 stand-in for std::span.
+template <typename T>
+class Span {
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+
+public:
+    Span() = default;
+    Span(T* data, size_t size): data_(data), size_(size) {}
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+    Span(std::vector<U>& items): data_(items.data()), size_(items.size()) {}
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<const U(*)[], T(*)[]>>>
+    Span(const std::vector<U>& items): data_(items.data()), size_(items.size()) {}
+
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+    T* data() const { return data_; }
+    T& operator[](size_t index) const { return data_[index]; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+};
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "MessageQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free single-producer/single-consumer ring buffer.
+// Exactly one thread may push and exactly one thread may pop at any given time.
+// The class is cache-line aligned so the producer line never shares with neighbouring allocations.
+template <typename T>
+class alignas(64) SpscRingBuffer : public MessageQueue<T> {
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) result <<= 1;
+        return result;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<T[]> buffer_;
+
+    // Consumer owned: read index plus a cached copy of the producer's write index
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
+
+    // Producer owned: write index plus a cached copy of the consumer's read index
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+
+    // Only touched when the consumer parks in waitPop, the push fast path just reads the flag
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> consumerParked_{false};
+    std::mutex parkMutex_;
+    std::condition_variable parkCondVar_;
+
+    std::atomic<size_t> droppedAfterClose_{0};
+
+    bool dropIfClosed() {
+        if (!this->closed_.load(std::memory_order_acquire)) return false;
+        droppedAfterClose_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void wakeParkedConsumer() {
+        // Pairs with the fence in waitPop: either the consumer sees the new tail or we see it parked
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumerParked_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(parkMutex_);
+            parkCondVar_.notify_one();
+        }
+    }
+
+    template <typename U>
+    bool tryPushImpl(U&& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ == capacity_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == capacity_) return false;
+        }
+
+        buffer_[tail & mask_] = std::forward<U>(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        wakeParkedConsumer();
+        return true;
+    }
+
+public:
+    explicit SpscRingBuffer(size_t capacity = 1024):
+        capacity_(roundUpToPowerOfTwo(capacity)),
+        mask_(capacity_ - 1),
+        buffer_(std::make_unique<T[]>(capacity_))
+        {
+            if (capacity == 0) throw std::invalid_argument("Ring buffer capacity must be greater than zero");
+        }
+
+    ~SpscRingBuffer() override = default;
+
+    //prevent copying and moving, the indices are shared with other threads
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+    SpscRingBuffer(SpscRingBuffer&&) = delete;
+    SpscRingBuffer& operator=(SpscRingBuffer&&) = delete;
+
+    //producer side
+    bool tryPush(const T& item) { return tryPushImpl(item); }
+    bool tryPush(T&& item) { return tryPushImpl(std::move(item)); }
+
+    // Blocking push, yields until the consumer frees a slot. Once the queue is closed its consumer
+    // may be gone, so a push that finds the ring full is dropped and counted instead of waiting forever.
+    void push(const T& item) override {
+        while (!tryPushImpl(item)) {
+            if (dropIfClosed()) return;
+            std::this_thread::yield();
+        }
+    }
+
+    void push(T&& item) override {
+        while (!tryPushImpl(std::move(item))) {
+            if (dropIfClosed()) return;
+            std::this_thread::yield();
+        }
+    }
+
+    bool singleProducer() const override { return true; }
+
+    // Pushes dropped because the ring was full after close()
+    size_t droppedAfterClose() const {
+        return droppedAfterClose_.load(std::memory_order_relaxed);
+    }
+
+    //consumer side
+    bool tryPop(T& item) override {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) return false;
+        }
+
+        item = std::move(buffer_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Parks on a condition variable instead of polling, a push or close wakes it immediately
+    bool waitPop(T& item, std::chrono::nanoseconds timeout) override {
+        if (tryPop(item)) return true;
+
+        {
+            std::unique_lock<std::mutex> lock(parkMutex_);
+            consumerParked_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            parkCondVar_.wait_for(lock, timeout, [this] {
+                return head_.load(std::memory_order_relaxed) != tail_.load(std::memory_order_acquire)
+                    || this->closed_.load(std::memory_order_acquire);
+            });
+            consumerParked_.store(false, std::memory_order_relaxed);
+        }
+
+        return tryPop(item);
+    }
+
+    void close() override {
+        {
+            std::lock_guard<std::mutex> lock(parkMutex_);
+            this->closed_.store(true, std::memory_order_release);
+        }
+        parkCondVar_.notify_all();
+    }
+
+    size_t drainTo(std::vector<T>& out, size_t maxItems) override {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        cachedTail_ = tail_.load(std::memory_order_acquire);
+        const size_t count = std::min(maxItems, cachedTail_ - head);
+
+        for (size_t i = 0; i < count; ++i) out.emplace_back(std::move(buffer_[(head + i) & mask_]));
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Approximate when called concurrently with push/tryPop
+    bool empty() const override {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    size_t size() const override {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "MarketDataStatsTracker.h"
+#include "Symbol.h"
+#include "SymbolStats.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The AVX2 kernel needs GCC/Clang target attributes and an x86-64 target, elsewhere only the scalar loop exists
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define STATS_COLUMNS_AVX2 1
+#endif
+
+// Column-per-field copy of a StatsSnapshot for bulk reporting. Every column is dense and indexed
+// like symbols, so derived metrics are straight loops over contiguous doubles: AVX2 when the CPU
+// has it, otherwise a branch-free scalar loop the compiler may vectorize itself.
+// The live store stays one seqlocked slot per symbol; columns are built from a snapshot.
+struct StatsColumns {
+    uint64_t version = 0;   // of the snapshot the columns came from
+    std::vector<Symbol> symbols;
+    std::vector<double> lastPrice;
+    std::vector<double> highPrice;
+    std::vector<double> lowPrice;
+    std::vector<double> volume;
+    std::vector<double> notional;
+
+    // Filled by computeDerived, zero for symbols without volume
+    std::vector<double> averagePrice;   // VWAP, notional / volume
+    std::vector<double> range;          // high - low
+    std::vector<double> vwapDeviation;  // (last - VWAP) / VWAP
+
+    static StatsColumns fromSnapshot(const StatsSnapshot& snapshot);
+
+    void reserve(size_t count);
+    void add(Symbol symbol, const SymbolStats& stats);
+    size_t size() const { return symbols.size(); }
+
+    void computeDerived();
+    void computeDerivedScalar(); // same results, never vectorized by hand; for checks and benchmarks
+
+    static bool vectorized(); // whether computeDerived takes the AVX2 path on this machine
+};
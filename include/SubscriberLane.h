@@ -0,0 +1,112 @@
+#pragma once
+
+#include "MarketDataMessage.h"
+#include "MarketDataSubscriber.h"
+#include "BoundedMessageQueue.h"
+#include "WaitStrategy.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+enum class DeliveryMode {
+    SYNCHRONOUS,    // callback runs on the dispatcher thread
+    ASYNCHRONOUS,   // callback runs on the subscriber's own lane thread
+    CONFLATED       // like ASYNCHRONOUS, but the lane keeps one pending update per symbol and
+                    // delivers only the newest state through onConflatedMarketData
+};
+
+struct SubscriptionOptions {
+    static constexpr const char* ALL_SYMBOLS = "*";
+
+    std::unordered_set<std::string> symbols;                // symbols to deliver, empty or ALL_SYMBOLS for every symbol
+    DeliveryMode deliveryMode = DeliveryMode::SYNCHRONOUS;
+    size_t laneCapacity = 4096;                             // messages buffered per lane before the overflow policy applies,
+                                                            // for CONFLATED the number of distinct symbols that can be pending
+    OverflowPolicy overflowPolicy = OverflowPolicy::DROP_OLDEST; // ignored by CONFLATED, which always conflates
+    WaitStrategy waitStrategy;                              // how the lane thread idles on an empty lane
+    std::string name;                                       // subscriber label in /metrics, "subscriber-<n>" when empty;
+                                                            // keep it unique, unsubscribing removes the labelled series
+
+    static SubscriptionOptions asynchronous(size_t capacity = 4096, OverflowPolicy policy = OverflowPolicy::DROP_OLDEST) {
+        SubscriptionOptions options;
+        options.deliveryMode = DeliveryMode::ASYNCHRONOUS;
+        options.laneCapacity = capacity;
+        options.overflowPolicy = policy;
+        return options;
+    }
+
+    static SubscriptionOptions conflated(size_t maxPendingSymbols = 4096) {
+        SubscriptionOptions options;
+        options.deliveryMode = DeliveryMode::CONFLATED;
+        options.laneCapacity = maxPendingSymbols;
+        options.overflowPolicy = OverflowPolicy::CONFLATE;
+        return options;
+    }
+};
+
+struct SubscriberLaneStats {
+    size_t queueDepth = 0;
+    uint64_t delivered = 0;                // callbacks made, a conflated update counts once
+    QueueDropCounters drops;               // droppedNewest also counts messages offered after stop()
+    std::chrono::nanoseconds lastLag{0};   // time the last delivered message spent waiting in the lane
+    std::chrono::nanoseconds maxLag{0};
+};
+
+// Decouples one subscriber from the dispatcher. onMarketData only enqueues, a dedicated thread
+// drains the lane and invokes the wrapped subscriber (in batches when it has fallen behind),
+// so a slow sink only backs up its own lane.
+class SubscriberLane : public IMarketDataSubscriber, public std::enable_shared_from_this<SubscriberLane> {
+private:
+    static constexpr size_t MAX_DELIVERY_BATCH = 256; // messages handed to the subscriber per onMarketDataBatch
+
+    struct LaneEntry {
+        MarketDataMessage message;
+        std::chrono::steady_clock::time_point enqueuedAt; // of the oldest message folded into this entry
+        int64_t accumulatedVolume = 0;
+        uint32_t messageCount = 0;
+    };
+
+    std::shared_ptr<IMarketDataSubscriber> subscriber_;
+    const DeliveryMode mode_;
+    BoundedMessageQueue<LaneEntry, SymbolId> lane_;
+    WaitStrategy waitStrategy_;
+
+    std::atomic<bool> running_;
+    std::atomic<uint32_t> pushing_{0};          // producers between their running_ check and the push, the lane thread drains them before exiting
+    std::atomic<uint64_t> droppedAfterStop_{0};
+    std::thread laneThread_;
+    std::shared_ptr<SubscriberLane> keepAlive_; // set when stop() runs on the lane thread itself, released as the loop exits
+
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<int64_t> lastLagNs_{0};
+    std::atomic<int64_t> maxLagNs_{0};
+
+    bool beginPush();
+    void laneLoop();
+    void deliver(std::vector<LaneEntry>& entries, std::vector<MarketDataMessage>& messages);
+
+public:
+    SubscriberLane(std::shared_ptr<IMarketDataSubscriber> subscriber, const SubscriptionOptions& options);
+    ~SubscriberLane() override;
+
+    //prevent copying and moving
+    SubscriberLane(const SubscriberLane&) = delete;
+    SubscriberLane& operator=(const SubscriberLane&) = delete;
+    SubscriberLane(SubscriberLane&&) = delete;
+    SubscriberLane& operator=(SubscriberLane&&) = delete;
+
+    void onMarketData(const MarketDataMessage& message) override;
+    void onMarketDataBatch(Span<const MarketDataMessage> messages) override;
+
+    void start();
+    void stop(); // delivers whatever is still queued, then joins the lane thread
+
+    const std::shared_ptr<IMarketDataSubscriber>& getSubscriber() const;
+    SubscriberLaneStats getStats() const;
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using SymbolId = uint32_t;
+
+// Process wide, append-only table handing out dense ids for ticker names. Interning takes a lock,
+// id -> name lookups never do: names live in fixed-size chunks that are never moved or freed.
+// Id 0 is reserved for the empty symbol so default constructed messages stay valid.
+class SymbolTable {
+private:
+    static constexpr size_t CHUNK_BITS = 12;
+    static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+    static constexpr size_t MAX_CHUNKS = 1024; // ~4M symbols
+
+    using Chunk = std::array<std::string, CHUNK_SIZE>;
+
+    std::array<std::atomic<Chunk*>, MAX_CHUNKS> chunks_{};
+    std::atomic<uint32_t> size_{0};
+
+    mutable std::shared_mutex mutex_; // guards ids_ and writers, never taken by name()
+    std::unordered_map<std::string, SymbolId> ids_;
+
+    SymbolTable() {
+        intern("");
+    }
+
+public:
+    static constexpr size_t MAX_SYMBOLS = CHUNK_SIZE * MAX_CHUNKS;
+
+    ~SymbolTable() {
+        for (auto& chunk : chunks_) delete chunk.load(std::memory_order_relaxed);
+    }
+
+    //prevent copying and moving
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    static SymbolTable& instance() {
+        static SymbolTable table;
+        return table;
+    }
+
+    SymbolId intern(std::string_view name) {
+        std::string key(name);
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = ids_.find(key);
+            if (it != ids_.end()) return it->second;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(key);
+        if (it != ids_.end()) return it->second;
+
+        const SymbolId id = size_.load(std::memory_order_relaxed);
+        const size_t chunkIndex = id >> CHUNK_BITS;
+        if (chunkIndex >= MAX_CHUNKS) throw std::length_error("Symbol table is full");
+
+        Chunk* chunk = chunks_[chunkIndex].load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = new Chunk();
+            chunks_[chunkIndex].store(chunk, std::memory_order_release);
+        }
+        (*chunk)[id & (CHUNK_SIZE - 1)] = key;
+
+        ids_.emplace(std::move(key), id);
+        size_.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    // Lookup without interning, for names coming from users (REST, CLI) that may not exist
+    std::optional<SymbolId> find(std::string_view name) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(std::string(name));
+        if (it == ids_.end()) return std::nullopt;
+        return it->second;
+    }
+
+    // The id must come from intern(); the returned reference stays valid for the life of the process
+    const std::string& name(SymbolId id) const {
+        return (*chunks_[id >> CHUNK_BITS].load(std::memory_order_acquire))[id & (CHUNK_SIZE - 1)];
+    }
+
+    size_t size() const {
+        return size_.load(std::memory_order_acquire);
+    }
+};
+
+// Interned ticker symbol, 4 bytes and trivially copyable. Converts implicitly from and to
+// std::string so existing code that builds or prints messages keeps working unchanged.
+class Symbol {
+private:
+    SymbolId id_ = 0;
+
+public:
+    Symbol() = default;
+    Symbol(std::string_view name): id_(SymbolTable::instance().intern(name)) {}
+    Symbol(const std::string& name): Symbol(std::string_view(name)) {}
+    Symbol(const char* name): Symbol(std::string_view(name)) {}
+
+    static Symbol fromId(SymbolId id) {
+        Symbol symbol;
+        symbol.id_ = id;
+        return symbol;
+    }
+
+    SymbolId id() const { return id_; }
+    const std::string& str() const { return SymbolTable::instance().name(id_); }
+    operator const std::string&() const { return str(); }
+
+    bool empty() const { return id_ == 0; }
+
+    friend bool operator==(Symbol lhs, Symbol rhs) { return lhs.id_ == rhs.id_; }
+    friend bool operator!=(Symbol lhs, Symbol rhs) { return lhs.id_ != rhs.id_; }
+
+    // Comparisons against raw names never intern them
+    friend bool operator==(Symbol lhs, const std::string& rhs) { return lhs.str() == rhs; }
+    friend bool operator==(const std::string& lhs, Symbol rhs) { return lhs == rhs.str(); }
+    friend bool operator!=(Symbol lhs, const std::string& rhs) { return lhs.str() != rhs; }
+    friend bool operator!=(const std::string& lhs, Symbol rhs) { return lhs != rhs.str(); }
+    friend bool operator==(Symbol lhs, const char* rhs) { return lhs.str() == rhs; }
+    friend bool operator==(const char* lhs, Symbol rhs) { return rhs.str() == lhs; }
+    friend bool operator!=(Symbol lhs, const char* rhs) { return lhs.str() != rhs; }
+    friend bool operator!=(const char* lhs, Symbol rhs) { return rhs.str() != lhs; }
+
+    friend std::ostream& operator<<(std::ostream& os, Symbol symbol) { return os << symbol.str(); }
+};
+
+namespace std {
+    template <>
+    struct hash<Symbol> {
+        size_t operator()(Symbol symbol) const noexcept { return std::hash<SymbolId>()(symbol.id()); }
+    };
+}
@@ -1,33 +1,157 @@
 #pragma once
 
 #include "MarketDataMessage.h"
+#include "Price.h"
 
 #include <unordered_map>
 #include <mutex>
 #include <algorithm>
 #include <memory>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// Settings for SymbolStats::update, built once by the tracker from its config
+struct SymbolStatsParams {
+    static constexpr size_t MAX_PRICE_EWMAS = 4;
+
+    size_t priceEwmaCount = 0;
+    double priceEwmaPerSecond[MAX_PRICE_EWMAS] = {};   // decay rates, see perSecond
+    double tradeRatePerSecond = perSecond(std::chrono::seconds(10));
+    double orderFlowPerSecond = perSecond(std::chrono::seconds(60));
+    bool tickRule = true;   // classify UNKNOWN-side trades as BUY on an uptick, SELL on a downtick
+
+    static double perSecond(std::chrono::milliseconds halfLife) {
+        return std::log(2.0) / std::chrono::duration<double>(halfLife).count();
+    }
+};
 
 struct SymbolStats {
-    double lastPrice = 0.00;
+    Price lastPrice;
+    Price openPrice;    // first trade seen, the reference for getChangePercent
     uint64_t totalVolume = 0;
     uint64_t tradeCount = 0;
-    double highPrice = std::numeric_limits<double>::lowest();
-    double lowPrice = std::numeric_limits<double>::max();
-    double totalNotional = 0.00;
+    Price highPrice = Price::min();
+    Price lowPrice = Price::max();
+    NotionalAccumulator totalNotional = 0; // sum of price * quantity in raw Price units, exact
     std::chrono::system_clock::time_point lastUpdateTime = std::chrono::system_clock::now();
 
-    void update(const MarketDataMessage& message) {
+    // Incremental analytics, O(1) per trade and no allocation. Time-weighted ones decay by the
+    // message timestamps; a trade stamped earlier than the previous one counts as simultaneous.
+    double priceEwma[SymbolStatsParams::MAX_PRICE_EWMAS] = {}; // one per configured half-life
+    double priceMean = 0.0;             // Welford running mean and sum of squared deviations
+    double priceM2 = 0.0;
+    double sumSquaredLogReturns = 0.0;  // trade to trade, for realized volatility
+    double tradeRate = 0.0;             // trades per second, exponentially weighted, as of lastUpdateTime
+
+    // Per-side aggregates. Trades whose side stays UNKNOWN only count in the totals above.
+    uint64_t buyVolume = 0;
+    uint64_t sellVolume = 0;
+    uint64_t buyCount = 0;
+    uint64_t sellCount = 0;
+    NotionalAccumulator buyNotional = 0;
+    NotionalAccumulator sellNotional = 0;
+    double orderFlowSigned = 0.0;       // buy minus sell volume, exponentially decayed
+    double orderFlowTotal = 0.0;        // buy plus sell volume, decayed alike
+    OrderSide lastTick = OrderSide::UNKNOWN; // direction of the last price change, for zero ticks
+
+    void update(const MarketDataMessage& message, const SymbolStatsParams& params = SymbolStatsParams()) {
+        const double price = message.price.toDouble();
+        OrderSide side = message.side;
+        if (tradeCount == 0) {
+            openPrice = message.price;
+            for (size_t i = 0; i < params.priceEwmaCount; ++i) priceEwma[i] = price;
+            tradeRate = params.tradeRatePerSecond;
+        } else {
+            const double elapsed = std::max(0.0, std::chrono::duration<double>(message.timestamp - lastUpdateTime).count());
+            for (size_t i = 0; i < params.priceEwmaCount; ++i) {
+                priceEwma[i] += (1.0 - std::exp(-params.priceEwmaPerSecond[i] * elapsed)) * (price - priceEwma[i]);
+            }
+            tradeRate = tradeRate * std::exp(-params.tradeRatePerSecond * elapsed) + params.tradeRatePerSecond;
+
+            const double orderFlowDecay = std::exp(-params.orderFlowPerSecond * elapsed);
+            orderFlowSigned *= orderFlowDecay;
+            orderFlowTotal *= orderFlowDecay;
+
+            if (message.price > lastPrice) lastTick = OrderSide::BUY;
+            else if (message.price < lastPrice) lastTick = OrderSide::SELL;
+            if (side == OrderSide::UNKNOWN && params.tickRule) side = lastTick;
+
+            const double previous = lastPrice.toDouble();
+            if (previous > 0.0 && price > 0.0) {
+                const double logReturn = std::log(price / previous);
+                sumSquaredLogReturns += logReturn * logReturn;
+            }
+        }
+
+        const double delta = price - priceMean;
+        priceMean += delta / static_cast<double>(tradeCount + 1);
+        priceM2 += delta * (price - priceMean);
+
+        const NotionalAccumulator notional = static_cast<NotionalAccumulator>(message.price.raw()) * message.quantity;
+        if (side == OrderSide::BUY) {
+            buyVolume += message.quantity;
+            buyCount++;
+            buyNotional += notional;
+            orderFlowSigned += message.quantity;
+            orderFlowTotal += message.quantity;
+        } else if (side == OrderSide::SELL) {
+            sellVolume += message.quantity;
+            sellCount++;
+            sellNotional += notional;
+            orderFlowSigned -= message.quantity;
+            orderFlowTotal += message.quantity;
+        }
+
         lastPrice = message.price;
         totalVolume += message.quantity;
         tradeCount++;
         highPrice = std::max(highPrice, message.price);
         lowPrice = std::min(lowPrice, message.price);
-        totalNotional += message.price * message.quantity;
+        totalNotional += notional;
         lastUpdateTime = message.timestamp;
     }
 
+    double getTotalNotional() const {
+        return static_cast<double>(totalNotional) / Price::SCALE;
+    }
+
     double getAveragePrice() const {
-        return totalVolume > 0? totalNotional / totalVolume : 0.00;
+        // The sums are exact in fixed point, but converting them to double rounds once a notional passes
+        // 2^53 raw units, and so do the multiply and the divide. That is a few ulps of relative error, not
+        // a correctly rounded VWAP.
+        return totalVolume > 0? static_cast<double>(totalNotional) / (static_cast<double>(totalVolume) * Price::SCALE) : 0.00;
+    }
+
+    double getChangePercent() const {
+        return openPrice.raw() != 0? 100.0 * static_cast<double>(lastPrice.raw() - openPrice.raw()) / static_cast<double>(openPrice.raw()) : 0.00;
+    }
+
+    // Sample variance of trade prices
+    double getPriceVariance() const {
+        return tradeCount > 1? priceM2 / static_cast<double>(tradeCount - 1) : 0.00;
+    }
+
+    double getPriceStdDev() const {
+        return std::sqrt(getPriceVariance());
+    }
+
+    double getBuyNotional() const {
+        return static_cast<double>(buyNotional) / Price::SCALE;
+    }
+
+    double getSellNotional() const {
+        return static_cast<double>(sellNotional) / Price::SCALE;
+    }
+
+    // (buy - sell) / (buy + sell) over the decayed volumes, from -1 (all selling) to 1 (all buying)
+    double getOrderFlowImbalance() const {
+        return orderFlowTotal > 0.0? orderFlowSigned / orderFlowTotal : 0.00;
+    }
+
+    // Square root of the summed squared log returns, not annualized
+    double getRealizedVolatility() const {
+        return std::sqrt(sumSquaredLogReturns);
     }
-};
\ No newline at end of file
+};
@@ -1,12 +1,18 @@
 #pragma once
+#include "MessageQueue.h"
+
 #include <deque>
 #include <mutex>
 #include <condition_variable>
+#include <chrono>
 #include <optional>
 #include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <iterator>
 
 template <typename T>
-class ThreadSafeMessageQueue {
+class ThreadSafeMessageQueue : public MessageQueue<T> {
 private:
     std::deque<T> queue_;
     mutable std::mutex mutex_;
@@ -17,7 +23,7 @@ public:
     ThreadSafeMessageQueue() = default;
 
     //destructor
-    ~ThreadSafeMessageQueue() = default;
+    ~ThreadSafeMessageQueue() override = default;
 
     //prevent copying
     ThreadSafeMessageQueue(const ThreadSafeMessageQueue&) = delete;
@@ -42,8 +48,37 @@ public:
         return item;
     }
 
-    bool tryPop(T& item) {
+    void pushBatch(Span<const T> items) override {
+        if (items.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.insert(queue_.end(), items.begin(), items.end());
+        }
+        condVar_.notify_all();
+    }
+
+    bool tryPop(T& item) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty()) return false;
+
+        item = std::move(queue_.front());
+        queue_.pop_front();
+        return true;
+    }
+
+    size_t drainTo(std::vector<T>& out, size_t maxItems) override {
         std::lock_guard<std::mutex> lock(mutex_);
+        const size_t count = std::min(maxItems, queue_.size());
+        auto last = queue_.begin() + static_cast<std::ptrdiff_t>(count);
+
+        out.insert(out.end(), std::make_move_iterator(queue_.begin()), std::make_move_iterator(last));
+        queue_.erase(queue_.begin(), last);
+        return count;
+    }
+
+    bool waitPop(T& item, std::chrono::nanoseconds timeout) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condVar_.wait_for(lock, timeout, [this] { return !queue_.empty() || this->closed_.load(std::memory_order_relaxed); });
         if (queue_.empty()) return false;
 
         item = std::move(queue_.front());
@@ -51,8 +86,21 @@ public:
         return true;
     }
 
+    void close() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            this->closed_.store(true, std::memory_order_release);
+        }
+        condVar_.notify_all();
+    }
+
+    void reopen() override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        this->closed_.store(false, std::memory_order_release);
+    }
+
     //rval push
-    void push(T&& item) {
+    void push(T&& item) override {
         {
             std::lock_guard<std::mutex> lock(mutex_);
             queue_.emplace_back(std::move(item));
@@ -61,7 +109,7 @@ public:
     }
 
     //lval push
-    void push(const T& item) {
+    void push(const T& item) override {
         {
             std::lock_guard<std::mutex> lock(mutex_);
             queue_.emplace_back(item);
@@ -69,12 +117,12 @@ public:
         condVar_.notify_one();
     }
 
-    bool empty() const {
+    bool empty() const override {
         std::lock_guard<std::mutex> lock(mutex_);
         return queue_.empty();
     }
 
-    size_t size() const {
+    size_t size() const override {
         std::lock_guard<std::mutex> lock(mutex_);
         return queue_.size();
     }
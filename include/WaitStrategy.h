@@ -0,0 +1,77 @@
+#pragma once
+
+#include "MessageQueue.h"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+enum class WaitMode {
+    BUSY_SPIN,  // never gives up the core, lowest handoff latency
+    SPIN_YIELD, // spins, then yields the core to other runnable threads
+    SPIN_PARK   // spins, then sleeps on the queue until a push or close wakes it
+};
+
+inline std::string to_string(WaitMode mode) {
+    switch (mode) {
+        case WaitMode::BUSY_SPIN:  return "BUSY_SPIN";
+        case WaitMode::SPIN_YIELD: return "SPIN_YIELD";
+        default:                   return "SPIN_PARK";
+    }
+}
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Idle policy for consumer loops. waitPop returns after at most one spin/yield/park round so the
+// caller can re-check its running flag; a false return means "nothing yet, call again".
+struct WaitStrategy {
+    WaitMode mode = WaitMode::SPIN_PARK;
+    size_t spinIterations = 64;                                   // tryPop + pause rounds before backing off
+    size_t yieldIterations = 16;                                  // tryPop + yield rounds (SPIN_YIELD)
+    std::chrono::nanoseconds parkTimeout = std::chrono::milliseconds(100); // longest single park (SPIN_PARK)
+
+    static WaitStrategy busySpin(size_t spins = 1024) {
+        return WaitStrategy{ WaitMode::BUSY_SPIN, spins, 0, std::chrono::nanoseconds::zero() };
+    }
+
+    static WaitStrategy spinYield(size_t spins = 64, size_t yields = 16) {
+        return WaitStrategy{ WaitMode::SPIN_YIELD, spins, yields, std::chrono::nanoseconds::zero() };
+    }
+
+    static WaitStrategy spinPark(size_t spins = 64, std::chrono::nanoseconds timeout = std::chrono::milliseconds(100)) {
+        return WaitStrategy{ WaitMode::SPIN_PARK, spins, 0, timeout };
+    }
+
+    template <typename T>
+    bool waitPop(MessageQueue<T>& queue, T& item) const {
+        for (size_t i = 0; i < spinIterations; ++i) {
+            if (queue.tryPop(item)) return true;
+            cpuRelax();
+        }
+
+        switch (mode) {
+            case WaitMode::BUSY_SPIN:
+                return queue.tryPop(item);
+            case WaitMode::SPIN_YIELD:
+                for (size_t i = 0; i < yieldIterations; ++i) {
+                    if (queue.tryPop(item)) return true;
+                    std::this_thread::yield();
+                }
+                return queue.tryPop(item);
+            case WaitMode::SPIN_PARK:
+                return queue.waitPop(item, parkTimeout);
+        }
+        return false;
+    }
+};
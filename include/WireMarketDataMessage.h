@@ -0,0 +1,89 @@
+#pragma once
+
+#include "MarketDataMessage.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+// Fixed layout, trivially copyable form of MarketDataMessage: one cache line that can be memcpy'd
+// through queues, written to and mmap'd from files, or placed in shared memory. The symbol travels
+// by name because SymbolIds are only meaningful inside the process that interned them.
+// Fields are in host byte order.
+struct alignas(64) WireMarketDataMessage {
+    static constexpr size_t MAX_SYMBOL_LENGTH = 31;
+
+    uint64_t sequence;                      // assigned by the writer, monotonic per stream
+    int64_t timestampNs;                    // nanoseconds since the system_clock epoch
+    int64_t price;                          // Price::raw(), millionths
+    uint32_t quantity;
+    uint8_t side;                           // OrderSide
+    uint8_t symbolLength;
+    uint8_t reserved[2];
+    char symbol[MAX_SYMBOL_LENGTH + 1];     // NUL padded
+
+    std::string_view symbolName() const {
+        return std::string_view(symbol, symbolLength);
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<WireMarketDataMessage>, "wire message must be memcpy-able");
+static_assert(std::is_standard_layout_v<WireMarketDataMessage>, "wire message must have a fixed layout");
+static_assert(sizeof(WireMarketDataMessage) == 64, "wire message must be exactly one cache line");
+static_assert(offsetof(WireMarketDataMessage, symbol) == 32, "wire message layout changed");
+
+// Fails for symbols longer than MAX_SYMBOL_LENGTH and for negative quantities
+inline std::optional<WireMarketDataMessage> toWire(const MarketDataMessage& message, uint64_t sequence) {
+    const std::string& name = message.symbol.str();
+    if (name.size() > WireMarketDataMessage::MAX_SYMBOL_LENGTH || message.quantity < 0) return std::nullopt;
+
+    WireMarketDataMessage wire{};
+    wire.sequence = sequence;
+    wire.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(message.timestamp.time_since_epoch()).count();
+    wire.price = message.price.raw();
+    wire.quantity = static_cast<uint32_t>(message.quantity);
+    wire.side = static_cast<uint8_t>(message.side);
+    wire.symbolLength = static_cast<uint8_t>(name.size());
+    std::memcpy(wire.symbol, name.data(), name.size());
+    return wire;
+}
+
+// How fromWire maps a symbol name onto the process wide SymbolTable, which never forgets a name
+enum class WireSymbolPolicy {
+    INTERN,     // new names are interned, for trusted streams written by this system
+    KNOWN_ONLY  // only names already interned are accepted, so outside input cannot grow the table
+};
+
+// Validates what a reader cannot trust in bytes from outside the process; an unknown symbol under
+// KNOWN_ONLY, or a new one once the symbol table is full, fails like any other bad input
+inline std::optional<MarketDataMessage> fromWire(const WireMarketDataMessage& wire, WireSymbolPolicy policy = WireSymbolPolicy::INTERN) {
+    if (wire.symbolLength > WireMarketDataMessage::MAX_SYMBOL_LENGTH) return std::nullopt;
+    if (wire.side > static_cast<uint8_t>(OrderSide::UNKNOWN)) return std::nullopt;
+    if (wire.quantity > static_cast<uint32_t>(std::numeric_limits<int>::max())) return std::nullopt;
+
+    std::optional<SymbolId> symbol;
+    if (policy == WireSymbolPolicy::KNOWN_ONLY) symbol = SymbolTable::instance().find(wire.symbolName());
+    else {
+        try {
+            symbol = SymbolTable::instance().intern(wire.symbolName());
+        } catch (const std::length_error&) {
+            return std::nullopt;
+        }
+    }
+    if (!symbol) return std::nullopt;
+
+    return MarketDataMessage{
+        .symbol = Symbol::fromId(*symbol),
+        .side = static_cast<OrderSide>(wire.side),
+        .price = Price::fromRaw(wire.price),
+        .quantity = static_cast<int>(wire.quantity),
+        .timestamp = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(wire.timestampNs)))
+    };
+}
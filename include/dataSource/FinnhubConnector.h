@@ -3,7 +3,7 @@
 #include "../MarketDataMessage.h"
 #include "../webSocket/IxWebSocketClient.h"
 #include "../parser/FinnhubMarketDataParser.h"
-#include "../ThreadSafeMessageQueue.h"
+#include "../MessageQueue.h"
 
 #include <string>
 #include <memory>
@@ -17,12 +17,13 @@ class FinnhubConnector {
 private:
     std::unique_ptr<IxWebSocketClient> wsClient_;
     std::unique_ptr<FinnhubMarketDataParser> parser_;
-    std::shared_ptr<ThreadSafeMessageQueue<MarketDataMessage>> messageQueue_;
+    std::shared_ptr<MessageQueue<MarketDataMessage>> messageQueue_;
     mutable std::mutex subscribedSymbolsMutex_;
     std::vector<std::string> subscribedSymbols_;
     std::thread workerThread_;
     std::atomic<bool> running_;
     std::atomic<bool> teardownRequested_ = false;
+    bool hasConnected_ = false; // worker thread only, later connects count as reconnects
 
 
     void tryConnect();
@@ -34,7 +35,7 @@ public:
     FinnhubConnector(
         std::unique_ptr<IxWebSocketClient> wsClient, 
         std::unique_ptr<FinnhubMarketDataParser> parser, 
-        std::shared_ptr<ThreadSafeMessageQueue<MarketDataMessage>> messageQueue, 
+        std::shared_ptr<MessageQueue<MarketDataMessage>> messageQueue, 
         std::vector<std::string> symbols = {}
     );
 
@@ -2,6 +2,8 @@
 
 #include "../testSubscribers/MarketStatsDataSubscriber.h"
 #include "../MarketDataStatsTracker.h"
+#include "../LatencyTracker.h"
+#include "../MetricsRegistry.h"
 
 #include "crow.h"
 #include <memory>
@@ -12,14 +14,19 @@
 class MarketDataRestApi {
 private:
     std::shared_ptr<MarketDataStatsTracker> statsTracker_;
+    std::shared_ptr<LatencyTracker> latencyTracker_; // optional, /latency is only served when set
     crow::SimpleApp app_;
     std::thread serverThread_;
     std::atomic<bool> running_{false};
 
     void runServer(uint16_t port);
+    std::string renderMetrics() const;
 
 public:
-    explicit MarketDataRestApi(std::shared_ptr<MarketDataStatsTracker> statsTracker);
+    explicit MarketDataRestApi(
+        std::shared_ptr<MarketDataStatsTracker> statsTracker,
+        std::shared_ptr<LatencyTracker> latencyTracker = nullptr
+    );
     ~MarketDataRestApi();
 
     // No copies allowed
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "../MarketDataSubscriber.h"
+#include "../MessageQueue.h"
 #include "../ThreadSafeMessageQueue.h"
+#include "../WaitStrategy.h"
+#include "../MetricsRegistry.h"
 
 #include "../utility/FilePathUtils.h"
 
@@ -14,7 +17,9 @@
 #include <mutex>
 #include <atomic>
 #include <thread>
+#include <memory>
 #include <stdexcept>
+#include <vector>
 
 class MarketDataFileLogger : public IMarketDataSubscriber {
 private:
@@ -24,7 +29,21 @@ private:
 
     std::atomic<bool> running_ = false;
     std::thread       loggingThread_;
-    ThreadSafeMessageQueue<MarketDataMessage> messageQueue_;
+    std::unique_ptr<MessageQueue<MarketDataMessage>> messageQueue_;
+    bool serializePushes_;      // single producer queues, e.g. SpscRingBuffer, while dispatchers may call from several threads
+    std::mutex producerMutex_;
+    WaitStrategy waitStrategy_;
+    Counter* bytesWritten_;
+    Counter* flushes_;
+
+    void writeLine(const MarketDataMessage& msg) {
+        auto timestamp = std::chrono::system_clock::to_time_t(msg.timestamp);
+        logFile_ << std::put_time(std::localtime(&timestamp), "%m-%d-%Y %H:%M:%S") << " "
+            << msg.symbol << " "
+            << to_string(msg.side) << " "
+            << std::fixed << std::setprecision(2) << msg.price << " "
+            << "x" << msg.quantity << "\n";
+    }
 
     void loggingLoop() {
         logFile_.open(filename_, std::ios::app);
@@ -32,35 +51,53 @@ private:
 
         size_t flushCounter = 0;
         const size_t FLUSH_THRESHOLD = 10; 
-
-        while (running_ || !messageQueue_.empty()) {
-            MarketDataMessage msg;
-            if (messageQueue_.tryPop(msg)) {
-                std::lock_guard<std::mutex> lock(fileMutex_);
-                auto timestamp = std::chrono::system_clock::to_time_t(msg.timestamp);
-                logFile_ << std::put_time(std::localtime(&timestamp), "%m-%d-%Y %H:%M:%S") << " "
-                    << msg.symbol << " "
-                    << to_string(msg.side) << " "
-                    << std::fixed << std::setprecision(2) << msg.price << " "
-                    << "x" << msg.quantity << "\n";
-                flushCounter++;
-                if (flushCounter >= FLUSH_THRESHOLD) {
-                    logFile_.flush();
-                    flushCounter = 0;
-                }
-            }
-            else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10)); // Sleep to avoid busy-waiting
+        const size_t MAX_BATCH = 256;
+
+        std::vector<MarketDataMessage> batch;
+        batch.reserve(MAX_BATCH);
+
+        while (running_ || !messageQueue_->empty()) {
+            batch.clear();
+
+            MarketDataMessage first;
+            if (!waitStrategy_.waitPop(*messageQueue_, first)) continue;
+            batch.emplace_back(std::move(first));
+            messageQueue_->drainTo(batch, MAX_BATCH - 1);
+
+            // One lock and at most one flush for everything that queued up since the last wakeup
+            std::lock_guard<std::mutex> lock(fileMutex_);
+            const auto before = logFile_.tellp();
+            for (const auto& msg : batch) writeLine(msg);
+            bytesWritten_->increment(static_cast<uint64_t>(logFile_.tellp() - before));
+            flushCounter += batch.size();
+            if (flushCounter >= FLUSH_THRESHOLD) {
+                logFile_.flush();
+                flushes_->increment();
+                flushCounter = 0;
             }
         }
 
         logFile_.flush(); // Ensure all remaining messages are written
+        flushes_->increment();
         logFile_.close();
     }
 
 public:
-    explicit MarketDataFileLogger(const std::string& relativePath):
-        filename_(relativePath)
+    // Any queue may be supplied. Sharded dispatch or batch delivery can call in from several threads,
+    // so pushes into a single producer queue such as SpscRingBuffer are serialized here.
+    explicit MarketDataFileLogger(
+        const std::string& relativePath,
+        std::unique_ptr<MessageQueue<MarketDataMessage>> messageQueue = nullptr,
+        const WaitStrategy& waitStrategy = WaitStrategy()
+    ):
+        filename_(relativePath),
+        messageQueue_(messageQueue? std::move(messageQueue) : std::make_unique<ThreadSafeMessageQueue<MarketDataMessage>>()),
+        serializePushes_(messageQueue_->singleProducer()),
+        waitStrategy_(waitStrategy),
+        bytesWritten_(&MetricsRegistry::instance().counter(
+            "dmhandler_file_logger_bytes_total", "Bytes written by a file logger", {{"file", relativePath}})),
+        flushes_(&MetricsRegistry::instance().counter(
+            "dmhandler_file_logger_flushes_total", "Flushes issued by a file logger", {{"file", relativePath}}))
         {
             if (relativePath.empty()) throw std::invalid_argument("Filename cannot be empty");
         
@@ -78,17 +115,27 @@ public:
     void start() {
         if (running_) return;
         running_ = true;
+        messageQueue_->reopen();
         loggingThread_ = std::thread(&MarketDataFileLogger::loggingLoop, this);
     }
     
     void stop() {
         if (!running_) return;
         running_ = false;
+        messageQueue_->close(); // wake the logging thread so it drains and exits immediately
         if (loggingThread_.joinable()) loggingThread_.join();
     }
 
     void onMarketData(const MarketDataMessage& message) override {
-        messageQueue_.push(message);
+        if (!serializePushes_) return messageQueue_->push(message);
+        std::lock_guard<std::mutex> lock(producerMutex_);
+        messageQueue_->push(message);
+    }
+
+    void onMarketDataBatch(Span<const MarketDataMessage> messages) override {
+        if (!serializePushes_) return messageQueue_->pushBatch(messages);
+        std::lock_guard<std::mutex> lock(producerMutex_);
+        messageQueue_->pushBatch(messages);
     }
 
 };
@@ -111,6 +158,13 @@ public:
         {
             fileLogger_.start();
         }
+
+    FileLoggerSubscriber(const std::string& filename, std::unique_ptr<MessageQueue<MarketDataMessage>> messageQueue):
+        filename_(filename),
+        fileLogger_(filename, std::move(messageQueue))
+        {
+            fileLogger_.start();
+        }
     
     ~FileLoggerSubscriber() {
         fileLogger_.stop();
@@ -127,4 +181,8 @@ public:
     void onMarketData(const MarketDataMessage& message) override {
         fileLogger_.onMarketData(message);
     }
+
+    void onMarketDataBatch(Span<const MarketDataMessage> messages) override {
+        fileLogger_.onMarketDataBatch(messages);
+    }
 };
\ No newline at end of file
@@ -6,14 +6,28 @@
 #include <iomanip>
 
 class LoggingSubscriber : public IMarketDataSubscriber {
+    private:
+        static void writeLine(std::ostream& out, const MarketDataMessage& message) {
+            out << "[LOG] "
+                << message.symbol << " "
+                << to_string(message.side)
+                << " @"
+                << std::fixed << std::setprecision(2) << message.price << " "
+                << "x" << message.quantity;
+        }
+
     public:
         void onMarketData(const MarketDataMessage& message) override {
-            std::cout << "[LOG] "
-                    << message.symbol << " "
-                    << to_string(message.side) << ""
-                    << " @"
-                    << std::fixed << std::setprecision(2) << message.price << " "
-                    << "x" << message.quantity 
-            << std::endl;
+            writeLine(std::cout, message);
+            std::cout << std::endl;
+        }
+
+        // Same format, but the console is flushed once per batch instead of once per line
+        void onMarketDataBatch(Span<const MarketDataMessage> messages) override {
+            for (const auto& message : messages) {
+                writeLine(std::cout, message);
+                std::cout << '\n';
+            }
+            std::cout.flush();
         }
     };
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "../include/BarBuilder.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+using namespace std;
+
+namespace {
+    // Start of the interval holding the timestamp, floored so pre-epoch times land in the right interval
+    chrono::system_clock::time_point intervalStart(chrono::system_clock::time_point timestamp, int64_t intervalMs) {
+        const int64_t ms = chrono::duration_cast<chrono::milliseconds>(timestamp.time_since_epoch()).count();
+        int64_t index = ms / intervalMs;
+        if (ms % intervalMs < 0) --index;
+        return chrono::system_clock::time_point(chrono::milliseconds(index * intervalMs));
+    }
+
+    Bar openBar(Symbol symbol, uint32_t spec, chrono::system_clock::time_point openTime, chrono::system_clock::time_point closeTime, Price open) {
+        Bar bar;
+        bar.symbol = symbol;
+        bar.spec = spec;
+        bar.openTime = openTime;
+        bar.closeTime = closeTime;
+        bar.open = open;
+        return bar;
+    }
+}
+
+BarBuilder::BarBuilder(const BarBuilderConfig& config):
+    specs_(config.specs),
+    history_(config.history),
+    subscribers_(make_shared<const vector<shared_ptr<IBarSubscriber>>>())
+    {
+        if (specs_.empty()) throw invalid_argument("Bar builder requires at least one bar spec");
+        if (specs_.size() > MAX_SPECS) throw invalid_argument("Bar builder supports at most " + to_string(MAX_SPECS) + " bar specs");
+        if (history_ == 0) throw invalid_argument("Bar history must hold at least one bar");
+
+        unordered_set<string> names;
+        for (const auto& spec : specs_) {
+            if (spec.size <= 0) throw invalid_argument("Bar spec " + spec.name + " must have a positive size");
+            if (!names.insert(spec.name).second) throw invalid_argument("Duplicate bar spec: " + spec.name);
+            barsClosed_.push_back(&MetricsRegistry::instance().counter(
+                "dmhandler_bars_closed_total", "Bars closed by the bar builder", {{"bar", spec.name}}));
+        }
+    }
+
+BarBuilder::SymbolBars& BarBuilder::barsFor(Symbol symbol) {
+    {
+        shared_lock<shared_mutex> lock(symbolsMutex_);
+        auto it = symbols_.find(symbol.id());
+        if (it != symbols_.end()) return *it->second;
+    }
+
+    unique_lock<shared_mutex> lock(symbolsMutex_);
+    auto& bars = symbols_[symbol.id()];
+    if (!bars) {
+        bars = make_unique<SymbolBars>();
+        bars->series.resize(specs_.size());
+        for (auto& series : bars->series) series.ring.resize(history_);
+    }
+    return *bars;
+}
+
+BarBuilder::SymbolBars* BarBuilder::findBars(const string& symbol) const {
+    auto id = SymbolTable::instance().find(symbol); // never intern names coming from callers
+    if (!id) return nullptr;
+
+    shared_lock<shared_mutex> lock(symbolsMutex_);
+    auto it = symbols_.find(*id);
+    return it == symbols_.end() ? nullptr : it->second.get();
+}
+
+optional<size_t> BarBuilder::findSpec(const string& name) const {
+    for (size_t i = 0; i < specs_.size(); ++i) {
+        if (specs_[i].name == name) return i;
+    }
+    return nullopt;
+}
+
+void BarBuilder::closeBar(Series& series, ClosedBars& closed) {
+    series.ring[series.next] = series.current;
+    series.next = (series.next + 1) % history_;
+    ++series.closed;
+    series.open = false;
+    closed.add(series.current);
+}
+
+void BarBuilder::publish(const ClosedBars& closed) {
+    if (closed.count == 0) return;
+
+    auto subscribers = atomic_load(&subscribers_);
+    for (size_t i = 0; i < closed.count; ++i) {
+        const Bar& bar = closed[i];
+        barsClosed_[bar.spec]->increment();
+        for (const auto& subscriber : *subscribers) subscriber->onBar(bar, specs_[bar.spec]);
+    }
+}
+
+void BarBuilder::onMarketData(const MarketDataMessage& message) {
+    SymbolBars& bars = barsFor(message.symbol);
+    ClosedBars closed;
+    {
+        lock_guard<mutex> lock(bars.mutex);
+        for (size_t i = 0; i < specs_.size(); ++i) {
+            const BarSpec& spec = specs_[i];
+            Series& series = bars.series[i];
+
+            if (spec.type == BarType::TIME) {
+                // A late trade from an earlier interval is folded into the open bar rather than reopening a closed one
+                const auto start = intervalStart(message.timestamp, spec.size);
+                if (series.open && start > series.current.openTime) closeBar(series, closed);
+                if (!series.open) {
+                    series.current = openBar(message.symbol, static_cast<uint32_t>(i), start, start + chrono::milliseconds(spec.size), message.price);
+                    series.open = true;
+                }
+            } else if (!series.open) {
+                series.current = openBar(message.symbol, static_cast<uint32_t>(i), message.timestamp, message.timestamp, message.price);
+                series.open = true;
+            }
+
+            Bar& bar = series.current;
+            bar.high = max(bar.high, message.price);
+            bar.low = min(bar.low, message.price);
+            bar.close = message.price;
+            bar.volume += message.quantity;
+            bar.tradeCount++;
+            bar.notional += static_cast<NotionalAccumulator>(message.price.raw()) * message.quantity;
+            if (spec.type != BarType::TIME) bar.closeTime = max(bar.closeTime, message.timestamp);
+
+            const bool full = (spec.type == BarType::TICK && bar.tradeCount >= static_cast<uint64_t>(spec.size)) ||
+                              (spec.type == BarType::VOLUME && bar.volume >= static_cast<uint64_t>(spec.size));
+            if (full) closeBar(series, closed);
+        }
+    }
+    publish(closed);
+}
+
+void BarBuilder::closeElapsed(chrono::system_clock::time_point asOf) {
+    vector<SymbolBars*> all;
+    {
+        shared_lock<shared_mutex> lock(symbolsMutex_);
+        all.reserve(symbols_.size());
+        for (const auto& [id, bars] : symbols_) all.push_back(bars.get());
+    }
+
+    for (SymbolBars* bars : all) {
+        ClosedBars closed;
+        {
+            lock_guard<mutex> lock(bars->mutex);
+            for (size_t i = 0; i < specs_.size(); ++i) {
+                Series& series = bars->series[i];
+                if (specs_[i].type == BarType::TIME && series.open && series.current.closeTime <= asOf) closeBar(series, closed);
+            }
+        }
+        publish(closed);
+    }
+}
+
+void BarBuilder::subscribe(shared_ptr<IBarSubscriber> subscriber) {
+    if (!subscriber) throw invalid_argument("Bar subscriber cannot be null");
+
+    lock_guard<mutex> lock(subscribersMutex_);
+    auto next = make_shared<vector<shared_ptr<IBarSubscriber>>>(*atomic_load(&subscribers_));
+    next->push_back(std::move(subscriber));
+    atomic_store(&subscribers_, shared_ptr<const vector<shared_ptr<IBarSubscriber>>>(std::move(next)));
+}
+
+void BarBuilder::unsubscribe(const shared_ptr<IBarSubscriber>& subscriber) {
+    lock_guard<mutex> lock(subscribersMutex_);
+    auto next = make_shared<vector<shared_ptr<IBarSubscriber>>>(*atomic_load(&subscribers_));
+    next->erase(remove(next->begin(), next->end(), subscriber), next->end());
+    atomic_store(&subscribers_, shared_ptr<const vector<shared_ptr<IBarSubscriber>>>(std::move(next)));
+}
+
+vector<Bar> BarBuilder::getBars(const string& symbol, const string& spec, size_t count) const {
+    auto index = findSpec(spec);
+    SymbolBars* bars = index ? findBars(symbol) : nullptr;
+    if (!bars) return {};
+
+    lock_guard<mutex> lock(bars->mutex);
+    const Series& series = bars->series[*index];
+    const size_t available = min(series.closed, history_);
+    count = min(count, available);
+
+    vector<Bar> result;
+    result.reserve(count);
+    size_t slot = (series.next + history_ - count) % history_;
+    for (size_t i = 0; i < count; ++i, slot = (slot + 1) % history_) result.push_back(series.ring[slot]);
+    return result;
+}
+
+optional<Bar> BarBuilder::getCurrentBar(const string& symbol, const string& spec) const {
+    auto index = findSpec(spec);
+    SymbolBars* bars = index ? findBars(symbol) : nullptr;
+    if (!bars) return nullopt;
+
+    lock_guard<mutex> lock(bars->mutex);
+    const Series& series = bars->series[*index];
+    if (!series.open) return nullopt;
+    return series.current;
+}
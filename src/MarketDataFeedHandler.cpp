@@ -1,60 +1,337 @@
 #include "../include/MarketDataFeedHandler.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <stdexcept>
 
 using namespace std;
 
-MarketDataFeedHandler::MarketDataFeedHandler(shared_ptr<ThreadSafeMessageQueue<MarketDataMessage>> messageQueue):
+atomic<uint64_t> MarketDataFeedHandler::subscriptionsCreated_{0};
+
+static const char* const CALLBACKS_METRIC = "dmhandler_subscriber_callbacks_total";
+static const char* const CALLBACK_SECONDS_METRIC = "dmhandler_subscriber_callback_seconds_total";
+
+MarketDataFeedHandler::MarketDataFeedHandler(
+    shared_ptr<MessageQueue<MarketDataMessage>> messageQueue,
+    const MarketDataFeedHandlerConfig& config
+):
+    config_(config),
     messageQueue_(messageQueue),
-    statsTracker_(make_shared<MarketDataStatsTracker>()),
-    running_(false)
-    { }
+    statsTracker_(make_shared<MarketDataStatsTracker>(config.stats)),
+    latencyTracker_(make_shared<LatencyTracker>()),
+    messagesDispatched_(MetricsRegistry::instance().counter("dmhandler_messages_dispatched_total", "Messages delivered to subscribers by the feed handler")),
+    queueDepth_(MetricsRegistry::instance().gauge("dmhandler_queue_depth", "Ingress queue backlog seen by the last dequeue")),
+    queueDepthHighWatermark_(MetricsRegistry::instance().gauge("dmhandler_queue_depth_high_watermark", "Largest ingress queue backlog seen by a dequeue")),
+    subscribers_(make_shared<const SubscriberList>()),
+    subscribersVersion_(0),
+    running_(false),
+    routing_(false)
+    {
+        if (config_.maxBatchSize == 0) throw invalid_argument("Dispatch batch size must be greater than zero");
+        if (config_.shardCount == 0) throw invalid_argument("Shard count must be greater than zero");
+
+        if (config_.shardCount > 1) {
+            for (size_t i = 0; i < config_.shardCount; ++i) {
+                shardQueues_.emplace_back(make_unique<SpscRingBuffer<MarketDataMessage>>(config_.shardQueueCapacity));
+            }
+        }
+    }
 
 MarketDataFeedHandler::~MarketDataFeedHandler() {
     stop();
+    for (const auto& subscription : atomic_load(&subscribers_)->subscriptions) {
+        if (subscription.lane) subscription.lane->stop();
+        releaseMetrics(subscription.metricName);
+    }
+}
+
+void MarketDataFeedHandler::releaseMetrics(const string& metricName) {
+    // Dispatchers still holding an old snapshot keep the counters alive, they just leave /metrics
+    auto& registry = MetricsRegistry::instance();
+    registry.remove(CALLBACKS_METRIC, {{"subscriber", metricName}});
+    registry.remove(CALLBACK_SECONDS_METRIC, {{"subscriber", metricName}});
 }
 
 const shared_ptr<MarketDataStatsTracker>& MarketDataFeedHandler::getStatsTracker() const {
     return statsTracker_;
 }
 
+const shared_ptr<LatencyTracker>& MarketDataFeedHandler::getLatencyTracker() const {
+    return latencyTracker_;
+}
+
+size_t MarketDataFeedHandler::getShardCount() const {
+    return config_.shardCount;
+}
+
+size_t MarketDataFeedHandler::shardFor(const string& symbol, size_t shardCount) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : symbol) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return static_cast<size_t>(hash % shardCount);
+}
+
 void MarketDataFeedHandler::subscribe(shared_ptr<IMarketDataSubscriber> subscriber) {
-    lock_guard<mutex> lock(subscriberMutex_);
-    subscribers_.push_back(subscriber);
+    subscribe(std::move(subscriber), SubscriptionOptions());
+}
+
+void MarketDataFeedHandler::subscribe(shared_ptr<IMarketDataSubscriber> subscriber, const unordered_set<string>& symbols) {
+    SubscriptionOptions options;
+    options.symbols = symbols;
+    subscribe(std::move(subscriber), options);
+}
+
+void MarketDataFeedHandler::subscribe(shared_ptr<IMarketDataSubscriber> subscriber, const SubscriptionOptions& options) {
+    Subscription subscription;
+    subscription.subscriber = subscriber;
+    subscription.symbols = options.symbols;
+    subscription.metricName = options.name.empty() ? "subscriber-" + std::to_string(++subscriptionsCreated_) : options.name;
+    auto& registry = MetricsRegistry::instance();
+    subscription.callbacks = registry.sharedCounter(CALLBACKS_METRIC, "Callbacks made to a subscriber", {{"subscriber", subscription.metricName}});
+    subscription.callbackNanos = registry.sharedCounter(
+        CALLBACK_SECONDS_METRIC, "Time spent inside a subscriber's callbacks", {{"subscriber", subscription.metricName}}, 1e-9);
+
+    if (!subscription.wantsAllSymbols()) {
+        for (const auto& symbol : options.symbols) subscription.symbolIds.push_back(Symbol(symbol).id());
+    }
+    if (subscriber && options.deliveryMode != DeliveryMode::SYNCHRONOUS) {
+        subscription.lane = make_shared<SubscriberLane>(subscriber, options);
+        subscription.lane->start();
+    }
+
+    lock_guard<mutex> lock(subscriberWriteMutex_);
+    auto next = atomic_load(&subscribers_)->subscriptions;
+    next.push_back(std::move(subscription));
+    publishSubscribers(std::move(next));
 }
 
 void MarketDataFeedHandler::unsubscribe(shared_ptr<IMarketDataSubscriber> subscriber) {
-    lock_guard<mutex> lock(subscriberMutex_);
-    auto it = find(subscribers_.begin(), subscribers_.end(), subscriber);
-    if (it != subscribers_.end()) subscribers_.erase(it);
+    shared_ptr<SubscriberLane> lane;
+    string metricName;
+    {
+        lock_guard<mutex> lock(subscriberWriteMutex_);
+        auto next = atomic_load(&subscribers_)->subscriptions;
+        auto it = find_if(next.begin(), next.end(), [&subscriber](const Subscription& subscription) {
+            return subscription.subscriber == subscriber;
+        });
+        if (it == next.end()) return;
+        lane = it->lane;
+        metricName = it->metricName;
+        next.erase(it);
+        publishSubscribers(std::move(next));
+    }
+
+    releaseMetrics(metricName);
+
+    // Flush the lane outside the lock so its remaining callbacks can subscribe/unsubscribe freely
+    if (lane) lane->stop();
+}
+
+MarketDataFeedHandler::SubscriberList::SubscriberList(vector<Subscription> subs):
+    subscriptions(std::move(subs))
+    {
+        for (const auto& subscription : subscriptions) {
+            if (!subscription.subscriber) continue;
+
+            if (subscription.wantsAllSymbols()) allSymbolSinks.push_back(subscription.sink());
+            else {
+                for (SymbolId id : subscription.symbolIds) {
+                    if (id >= filteredSinksBySymbol.size()) filteredSinksBySymbol.resize(id + 1);
+                    filteredSinksBySymbol[id].push_back(subscription.sink());
+                    hasFilteredSinks = true;
+                }
+            }
+        }
+    }
+
+const vector<MarketDataFeedHandler::Sink>& MarketDataFeedHandler::SubscriberList::filteredSinksFor(Symbol symbol) const {
+    static const vector<Sink> none;
+    return symbol.id() < filteredSinksBySymbol.size() ? filteredSinksBySymbol[symbol.id()] : none;
+}
+
+void MarketDataFeedHandler::publishSubscribers(vector<Subscription> subscriptions) {
+    atomic_store(&subscribers_, shared_ptr<const SubscriberList>(make_shared<SubscriberList>(std::move(subscriptions))));
+    subscribersVersion_.fetch_add(1, memory_order_release);
+}
+
+const MarketDataFeedHandler::SubscriberList& MarketDataFeedHandler::currentSubscribers(SubscriberView& view) const {
+    // The list is stored before the version is bumped, so a new version always finds a snapshot at least that new
+    const uint64_t version = subscribersVersion_.load(memory_order_acquire);
+    if (version != view.version) {
+        view.subscribers = atomic_load(&subscribers_);
+        view.version = version;
+    }
+    return *view.subscribers;
+}
+
+optional<SubscriberLaneStats> MarketDataFeedHandler::getLaneStats(const shared_ptr<IMarketDataSubscriber>& subscriber) const {
+    for (const auto& subscription : atomic_load(&subscribers_)->subscriptions) {
+        if (subscription.subscriber == subscriber && subscription.lane) return subscription.lane->getStats();
+    }
+    return nullopt;
 }
 
 void MarketDataFeedHandler::start() {
     if (running_) return;
     running_ = true;
-    dispatcherThread_ = thread(&MarketDataFeedHandler::dispatchLoop, this);
+    routing_ = true;
+    messageQueue_->reopen();
+
+    if (shardQueues_.empty()) {
+        dispatcherThreads_.emplace_back(&MarketDataFeedHandler::dispatchLoop, this, ref(*messageQueue_));
+        return;
+    }
+
+    for (auto& shardQueue : shardQueues_) {
+        shardQueue->reopen();
+        dispatcherThreads_.emplace_back(&MarketDataFeedHandler::dispatchLoop, this, ref(*shardQueue));
+    }
+    routerThread_ = thread(&MarketDataFeedHandler::routeLoop, this);
 }
 
 void MarketDataFeedHandler::stop() {
     if (!running_) return;
+
+    // Stop the router first so everything it already took off the ingress queue reaches a shard
+    routing_ = false;
+    messageQueue_->close(); // wake the router (or the single dispatcher) if it is blocked on an empty queue
+    if (routerThread_.joinable()) routerThread_.join();
+
+    // Shard workers keep going until their ring is closed and empty, so every routed message is delivered
     running_ = false;
-    if (dispatcherThread_.joinable()) dispatcherThread_.join();
+    for (auto& shardQueue : shardQueues_) shardQueue->close();
+    for (auto& dispatcherThread : dispatcherThreads_) {
+        if (dispatcherThread.joinable()) dispatcherThread.join();
+    }
+    dispatcherThreads_.clear();
+}
+
+void MarketDataFeedHandler::routeLoop() {
+    vector<MarketDataMessage> batch;
+    batch.reserve(config_.maxBatchSize);
+
+    while (routing_) {
+        batch.clear();
+
+        MarketDataMessage first;
+        if (!config_.waitStrategy.waitPop(*messageQueue_, first)) continue;
+        batch.emplace_back(std::move(first));
+        messageQueue_->drainTo(batch, config_.maxBatchSize - 1);
+        observeIngressDepth(batch.size());
+
+        for (auto& msg : batch) {
+            const SymbolId id = msg.symbol.id();
+            if (id >= shardBySymbol_.size()) shardBySymbol_.resize(id + 1, SIZE_MAX);
+            if (shardBySymbol_[id] == SIZE_MAX) shardBySymbol_[id] = shardFor(msg.symbol, shardQueues_.size());
+
+            shardQueues_[shardBySymbol_[id]]->push(std::move(msg));
+        }
+    }
+}
+
+void MarketDataFeedHandler::dispatchLoop(MessageQueue<MarketDataMessage>& queue) {
+    vector<MarketDataMessage> batch;
+    batch.reserve(config_.maxBatchSize);
+    SubscriberView view;
+    // Only shard rings are drained on stop, the router has been joined so nothing more can arrive.
+    // The ingress queue keeps its backlog for the next start, producers may still be pushing into it.
+    const bool drainOnStop = !shardQueues_.empty();
+
+    while (running_ || (drainOnStop && !queue.empty())) {
+        batch.clear();
+
+        // Wait for the first message per the configured strategy, then take whatever else is already queued
+        MarketDataMessage first;
+        if (!config_.waitStrategy.waitPop(queue, first)) continue;
+        batch.emplace_back(std::move(first));
+        queue.drainTo(batch, config_.maxBatchSize - 1);
+        if (shardQueues_.empty()) observeIngressDepth(batch.size());
+
+        int64_t dequeuedNs = 0;
+        if (config_.latencyTracking) {
+            dequeuedNs = latencyClockNs();
+            for (const auto& msg : batch) {
+                latencyTracker_->recordSpan(LatencyStage::PARSE, msg.ingressNs, msg.enqueueNs);
+                latencyTracker_->recordSpan(LatencyStage::QUEUE, msg.enqueueNs, dequeuedNs);
+            }
+        }
+
+        dispatchBatch(batch, view, dequeuedNs);
+    }
+}
+
+void MarketDataFeedHandler::observeIngressDepth(size_t drained) {
+    const int64_t depth = static_cast<int64_t>(drained + messageQueue_->size());
+    queueDepth_.set(depth);
+    queueDepthHighWatermark_.setMax(depth);
+}
+
+int64_t MarketDataFeedHandler::startCallback() const {
+    return config_.latencyTracking ? latencyClockNs() : 0;
 }
 
-void MarketDataFeedHandler::dispatchLoop() {
-    while (running_) {
-        MarketDataMessage msg;
+// The clock is read around each callback, so stats updates and latency recording are never charged to a subscriber
+int64_t MarketDataFeedHandler::finishCallback(const Sink& sink, int64_t startNs) {
+    sink.callbacks->increment();
+    if (startNs == 0) return 0;
 
-        if (messageQueue_->tryPop(msg)) {
-            lock_guard<mutex> lock(subscriberMutex_);
-            statsTracker_->update(msg);
-            for (const auto& sub : subscribers_) {
-                if (sub) sub->onMarketData(msg);
+    const int64_t nowNs = latencyClockNs();
+    sink.callbackNanos->increment(static_cast<uint64_t>(nowNs - startNs));
+    return nowNs;
+}
+
+void MarketDataFeedHandler::recordDelivered(const MarketDataMessage& message, int64_t dequeuedNs, int64_t deliveredNs) {
+    latencyTracker_->record(LatencyStage::DISPATCH, deliveredNs - dequeuedNs);
+    latencyTracker_->recordSpan(LatencyStage::END_TO_END, message.ingressNs, deliveredNs);
+}
+
+void MarketDataFeedHandler::dispatchBatch(const vector<MarketDataMessage>& batch, SubscriberView& view, int64_t dequeuedNs) {
+    statsTracker_->update(batch);
+    messagesDispatched_.increment(batch.size());
+
+    if (config_.batchDelivery && batch.size() > 1) {
+        // One snapshot for the whole backlog: wildcard subscribers take it in a single call,
+        // filtered subscribers still receive only their own symbols
+        const SubscriberList& subscribers = currentSubscribers(view);
+        for (const Sink& sink : subscribers.allSymbolSinks) {
+            const int64_t startNs = startCallback();
+            sink.target->onMarketDataBatch(batch);
+            const int64_t deliveredNs = finishCallback(sink, startNs);
+            if (deliveredNs == 0) continue;
+            for (const auto& msg : batch) recordDelivered(msg, dequeuedNs, deliveredNs);
+        }
+        if (!subscribers.hasFilteredSinks) return;
+
+        for (const auto& msg : batch) {
+            for (const Sink& sink : subscribers.filteredSinksFor(msg.symbol)) {
+                const int64_t startNs = startCallback();
+                sink.target->onMarketData(msg);
+                const int64_t deliveredNs = finishCallback(sink, startNs);
+                if (deliveredNs != 0) recordDelivered(msg, dequeuedNs, deliveredNs);
             }
         }
-        else {
-            this_thread::sleep_for(chrono::milliseconds(1));
+        return;
+    }
+
+    // Re-checked per message so subscribe/unsubscribe take effect on the next message, even mid-batch
+    for (const auto& msg : batch) {
+        const SubscriberList& subscribers = currentSubscribers(view);
+        for (const Sink& sink : subscribers.allSymbolSinks) {
+            const int64_t startNs = startCallback();
+            sink.target->onMarketData(msg);
+            const int64_t deliveredNs = finishCallback(sink, startNs);
+            if (deliveredNs != 0) recordDelivered(msg, dequeuedNs, deliveredNs);
+        }
+        if (!subscribers.hasFilteredSinks) continue;
+        for (const Sink& sink : subscribers.filteredSinksFor(msg.symbol)) {
+            const int64_t startNs = startCallback();
+            sink.target->onMarketData(msg);
+            const int64_t deliveredNs = finishCallback(sink, startNs);
+            if (deliveredNs != 0) recordDelivered(msg, dequeuedNs, deliveredNs);
         }
     }
 }
\ No newline at end of file
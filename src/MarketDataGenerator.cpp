@@ -36,11 +36,12 @@ vector<MarketDataMessage> MarketDataGenerator::generate() {
     uniform_int_distribution<size_t> symbolIndexDist(0, config_.symbols.size() - 1);
 
     auto now = chrono::system_clock::now();
+    const vector<Symbol> symbols(config_.symbols.begin(), config_.symbols.end()); // intern once, not per message
 
     for (size_t i = 0; i < config_.numMessages; ++i) {
         MarketDataMessage msg;
 
-        msg.symbol = config_.symbols[symbolIndexDist(rng_)];
+        msg.symbol = symbols[symbolIndexDist(rng_)];
         msg.side = static_cast<OrderSide>(sideDist(rng_));
         msg.price = priceDist(rng_);
         msg.quantity = static_cast<int>(quantityDist(rng_));
@@ -2,6 +2,8 @@
 #include "../include/MarketDataMessage.h"
 #include "../include/OrderSide.h"
 #include "../include/MarketDataGenerator.h"
+#include "../include/LatencyHistogram.h"
+#include "../include/MetricsRegistry.h"
 
 
 #include <fstream>
@@ -75,12 +77,15 @@ chrono::steady_clock::duration MarketDataSimulator::getReplayOffset(
 }
 
 void MarketDataSimulator::run() {
+    static Counter& received = MetricsRegistry::instance().counter(
+        "dmhandler_messages_received_total", "Raw messages received from a data source", {{"source", "simulator"}});
 
     if (sourceType_ == SourceType::FILE) {
         auto messages = loadFromFile(filePath_);
 
         for (const auto& rawLine : messages) {
             if (!running_) break;
+            received.increment();
             fileSink_(rawLine);
             this_thread::sleep_for(getReplayDelay());
         }
@@ -118,6 +123,9 @@ void MarketDataSimulator::run() {
 
             MarketDataMessage emitted = msg;
             emitted.timestamp = chrono::system_clock::now();
+            emitted.ingressNs = latencyClockNs();
+            emitted.enqueueNs = emitted.ingressNs; // generated messages need no parsing, the sink enqueues directly
+            received.increment();
             generatedSink_(emitted);
         }
     }
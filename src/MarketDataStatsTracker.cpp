@@ -2,30 +2,335 @@
 #include "../include/MarketDataStatsTracker.h"
 #include "../include/SymbolStats.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
 #include <mutex>
-#include <iostream>
+#include <thread>
 
 
+void MarketDataStatsTracker::StatsSlot::write(const SymbolStats& stats) {
+    uint64_t buffer[WORDS] = {};
+    std::memcpy(buffer, &stats, sizeof(SymbolStats));
+    for (size_t i = 0; i < WORDS; ++i) words[i].store(buffer[i], std::memory_order_relaxed);
+}
+
+void MarketDataStatsTracker::StatsSlot::readUnsynchronized(SymbolStats& stats) const {
+    uint64_t buffer[WORDS];
+    for (size_t i = 0; i < WORDS; ++i) buffer[i] = words[i].load(std::memory_order_relaxed);
+    std::memcpy(&stats, buffer, sizeof(SymbolStats));
+}
+
+bool MarketDataStatsTracker::StatsSlot::tryRead(SymbolStats& stats) const {
+    const uint32_t before = sequence.load(std::memory_order_acquire);
+    if (before & 1) return false;
+
+    readUnsynchronized(stats);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return sequence.load(std::memory_order_relaxed) == before;
+}
+
+MarketDataStatsTracker::MarketDataStatsTracker(const MarketDataStatsTrackerConfig& config):
+    config_(config)
+    {
+        RollingWindows validate(config_.windows); // throws on a bad window or sketch before any update needs it
+        if (config_.quantiles) {
+            QuantileSketch validatePrice(config_.priceSketch);
+            QuantileSketch validateQuantity(config_.quantitySketch);
+        }
+
+        if (config_.priceEwmas.size() > SymbolStatsParams::MAX_PRICE_EWMAS) throw std::invalid_argument("Too many price EWMAs");
+        for (size_t i = 0; i < config_.priceEwmas.size(); ++i) {
+            const auto& spec = config_.priceEwmas[i];
+            if (spec.halfLife.count() <= 0) throw std::invalid_argument("Price EWMA " + spec.name + " needs a positive half-life");
+            for (size_t j = 0; j < i; ++j) {
+                if (config_.priceEwmas[j].name == spec.name) throw std::invalid_argument("Duplicate price EWMA: " + spec.name);
+            }
+            statsParams_.priceEwmaPerSecond[i] = SymbolStatsParams::perSecond(spec.halfLife);
+        }
+        statsParams_.priceEwmaCount = config_.priceEwmas.size();
+
+        if (config_.tradeRateHalfLife.count() <= 0) throw std::invalid_argument("Trade rate needs a positive half-life");
+        statsParams_.tradeRatePerSecond = SymbolStatsParams::perSecond(config_.tradeRateHalfLife);
+
+        if (config_.orderFlowHalfLife.count() <= 0) throw std::invalid_argument("Order flow imbalance needs a positive half-life");
+        statsParams_.orderFlowPerSecond = SymbolStatsParams::perSecond(config_.orderFlowHalfLife);
+        statsParams_.tickRule = config_.tickRule;
+
+        for (auto& leaderboard : leaderboards_) leaderboard = std::make_unique<Leaderboard>(config_.leaderboardSize);
+        for (size_t i = 0; i < config_.windows.size(); ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                if (config_.windows[i].name == config_.windows[j].name) throw std::invalid_argument("Duplicate rolling window: " + config_.windows[i].name);
+            }
+        }
+    }
+
+MarketDataStatsTracker::~MarketDataStatsTracker() {
+    for (auto& chunk : chunks_) delete chunk.load(std::memory_order_relaxed);
+}
+
+MarketDataStatsTracker::StatsSlot& MarketDataStatsTracker::slotFor(SymbolId id) {
+    auto& chunkPtr = chunks_[id >> CHUNK_BITS];
+    Chunk* chunk = chunkPtr.load(std::memory_order_acquire);
+    if (!chunk) {
+        std::lock_guard<std::mutex> lock(trackedMutex_);
+        chunk = chunkPtr.load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = new Chunk();
+            chunkPtr.store(chunk, std::memory_order_release);
+        }
+    }
+    return (*chunk)[id & (CHUNK_SIZE - 1)];
+}
+
+const MarketDataStatsTracker::StatsSlot* MarketDataStatsTracker::findSlot(SymbolId id) const {
+    if ((id >> CHUNK_BITS) >= MAX_CHUNKS) return nullptr;
+    const Chunk* chunk = chunks_[id >> CHUNK_BITS].load(std::memory_order_acquire);
+    return chunk ? &(*chunk)[id & (CHUNK_SIZE - 1)] : nullptr;
+}
+
+void MarketDataStatsTracker::apply(const MarketDataMessage& message, SymbolStats& scratch) {
+    StatsSlot& slot = slotFor(message.symbol.id());
+
+    // Concurrent writers to one symbol (rare, a symbol is normally owned by one dispatcher) take turns
+    uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    while ((sequence & 1) || !slot.sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire)) {
+        if (sequence & 1) {
+            std::this_thread::yield();
+            sequence = slot.sequence.load(std::memory_order_relaxed);
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release); // the odd sequence is visible before any word changes
+
+    slot.readUnsynchronized(scratch);
+    const bool firstSight = scratch.tradeCount == 0;
+    if (firstSight) scratch = SymbolStats();
+    const SymbolStats before = scratch;
+    scratch.update(message, statsParams_);
+    slot.write(scratch);
+    offerLeaders(message.symbol, before, scratch); // under the odd sequence, so one symbol's offers stay in order
+
+    if (!config_.windows.empty()) {
+        RollingWindows* windows = slot.windows.load(std::memory_order_relaxed);
+        if (!windows) {
+            windows = new RollingWindows(config_.windows);
+            slot.windows.store(windows, std::memory_order_release);
+        }
+        windows->update(message);
+    }
+
+    if (config_.quantiles) {
+        SymbolQuantiles* quantiles = slot.quantiles.load(std::memory_order_relaxed);
+        if (!quantiles) {
+            quantiles = new SymbolQuantiles{ QuantileSketch(config_.priceSketch), QuantileSketch(config_.quantitySketch) };
+            slot.quantiles.store(quantiles, std::memory_order_release);
+        }
+        quantiles->price.add(message.price.toDouble());
+        quantiles->quantity.add(message.quantity);
+    }
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+
+    if (firstSight) {
+        std::lock_guard<std::mutex> lock(trackedMutex_);
+        trackedSymbols_.push_back(message.symbol.id());
+    }
+}
+
+void MarketDataStatsTracker::offerLeaders(Symbol symbol, const SymbolStats& before, const SymbolStats& after) {
+    if (config_.leaderboardSize == 0) return;
+
+    leaderboards_[static_cast<size_t>(LeaderboardMetric::VOLUME)]->offer(symbol, before.totalVolume, after.totalVolume);
+    leaderboards_[static_cast<size_t>(LeaderboardMetric::TRADE_COUNT)]->offer(symbol, before.tradeCount, after.tradeCount);
+    leaderboards_[static_cast<size_t>(LeaderboardMetric::NOTIONAL)]->offer(symbol, before.getTotalNotional(), after.getTotalNotional());
+}
+
+void MarketDataStatsTracker::beginUpdate() {
+    updatesStarted_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release); // counted before any slot changes
+}
+
+void MarketDataStatsTracker::endUpdate() {
+    updatesFinished_.fetch_add(1, std::memory_order_release);
+}
+
 void MarketDataStatsTracker::update(const MarketDataMessage& message) {
-    std::lock_guard<std::mutex> lock(statsMutex_);
-    auto& stats = stats_[message.symbol];
-    stats.update(message);
+    SymbolStats scratch;
+    beginUpdate();
+    apply(message, scratch);
+    endUpdate();
+}
+
+void MarketDataStatsTracker::update(const std::vector<MarketDataMessage>& messages) {
+    SymbolStats scratch; // reused so a batch constructs one SymbolStats, not one per message
+    beginUpdate();
+    for (const auto& message : messages) apply(message, scratch);
+    endUpdate();
 }
 
 SymbolStats MarketDataStatsTracker::getStats(const std::string& symbol) const {
-    std::lock_guard<std::mutex> lock(statsMutex_);
+    auto id = SymbolTable::instance().find(symbol);
+    if (!id) return SymbolStats();
+    return getStats(*id);
+}
+
+SymbolStats MarketDataStatsTracker::getStats(SymbolId id) const {
+    const StatsSlot* slot = findSlot(id);
+    if (!slot) return SymbolStats();
+
+    SymbolStats stats;
+    while (!slot->tryRead(stats)) std::this_thread::yield();
+
+    if (stats.tradeCount == 0) return SymbolStats();
+    return stats;
+}
+
+std::optional<WindowStats> MarketDataStatsTracker::getWindowStats(
+    const std::string& symbol,
+    const std::string& window,
+    std::chrono::system_clock::time_point asOf
+) const {
+    size_t windowIndex = 0;
+    while (windowIndex < config_.windows.size() && config_.windows[windowIndex].name != window) ++windowIndex;
+    if (windowIndex == config_.windows.size()) return std::nullopt;
+
+    auto id = SymbolTable::instance().find(symbol);
+    const StatsSlot* slot = id ? findSlot(*id) : nullptr;
+    if (!slot) return WindowStats();
+
+    // Same seqlock protocol as tryRead, over the window buckets instead of the stats words
+    while (true) {
+        const uint32_t before = slot->sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const RollingWindows* windows = slot->windows.load(std::memory_order_acquire);
+        WindowStats stats = windows ? windows->read(windowIndex, asOf) : WindowStats();
 
-    auto it = stats_.find(symbol);
-    if (it != stats_.end()) return it->second;
-    return SymbolStats();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) == before) return stats;
+    }
+}
+
+std::optional<SymbolQuantiles> MarketDataStatsTracker::getQuantiles(const std::string& symbol) const {
+    if (!config_.quantiles) return std::nullopt;
+
+    SymbolQuantiles result{ QuantileSketch(config_.priceSketch), QuantileSketch(config_.quantitySketch) };
+    auto id = SymbolTable::instance().find(symbol);
+    const StatsSlot* slot = id ? findSlot(*id) : nullptr;
+    if (!slot) return result;
+
+    // Same seqlock protocol as getWindowStats, the copies reuse result's buckets on a retry
+    while (true) {
+        const uint32_t before = slot->sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        if (const SymbolQuantiles* quantiles = slot->quantiles.load(std::memory_order_acquire)) {
+            result.price = quantiles->price;
+            result.quantity = quantiles->quantity;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) == before) return result;
+    }
+}
+
+std::vector<std::string> MarketDataStatsTracker::getWindowNames() const {
+    std::vector<std::string> names;
+    for (const auto& spec : config_.windows) names.push_back(spec.name);
+    return names;
+}
+
+std::vector<std::string> MarketDataStatsTracker::getPriceEwmaNames() const {
+    std::vector<std::string> names;
+    for (const auto& spec : config_.priceEwmas) names.push_back(spec.name);
+    return names;
+}
+
+std::vector<LeaderboardEntry> MarketDataStatsTracker::getLeaders(LeaderboardMetric metric, size_t n) const {
+    if (metric != LeaderboardMetric::CHANGE) return leaderboards_[static_cast<size_t>(metric)]->top(n);
+
+    // A move can shrink, which the incremental boards cannot follow, so change is ranked from a snapshot
+    n = std::min(n, config_.leaderboardSize);
+    const auto current = snapshot();
+    std::vector<LeaderboardEntry> movers;
+    movers.reserve(current->symbols.size());
+    for (const auto& [symbol, stats] : current->symbols) movers.push_back({ symbol, stats.getChangePercent() });
+
+    n = std::min(n, movers.size());
+    auto bySize = [](const LeaderboardEntry& lhs, const LeaderboardEntry& rhs) { return std::abs(lhs.value) > std::abs(rhs.value); };
+    std::partial_sort(movers.begin(), movers.begin() + n, movers.end(), bySize);
+    movers.resize(n);
+    return movers;
 }
 
 std::vector<std::string> MarketDataStatsTracker::getAllSymbols() const {
-    std::lock_guard<std::mutex> lock(statsMutex_);
+    std::lock_guard<std::mutex> lock(trackedMutex_);
 
     std::vector<std::string> symbols;
-    symbols.resize(stats_.size());
-    std::transform(stats_.begin(), stats_.end(), symbols.begin(),
-                   [](const auto& pair) { return pair.first; });
+    symbols.reserve(trackedSymbols_.size());
+    for (SymbolId id : trackedSymbols_) symbols.push_back(Symbol::fromId(id).str());
     return symbols;
-}
\ No newline at end of file
+}
+
+bool MarketDataStatsTracker::readAll(StatsSnapshot& snapshot, bool bestEffort) const {
+    const uint64_t finished = updatesFinished_.load(std::memory_order_acquire);
+    const uint64_t started = updatesStarted_.load(std::memory_order_acquire);
+    // An update in flight may have half applied its batch, only a best effort pass reads through it
+    if (started != finished && !bestEffort) return false;
+
+    std::vector<SymbolId> ids;
+    {
+        std::lock_guard<std::mutex> lock(trackedMutex_);
+        ids = trackedSymbols_;
+    }
+
+    snapshot.version = finished;
+    snapshot.takenAt = std::chrono::system_clock::now();
+    snapshot.symbols.clear();
+    snapshot.symbols.reserve(ids.size());
+    for (SymbolId id : ids) {
+        const StatsSlot* slot = findSlot(id);
+        if (!slot) continue;
+
+        SymbolStats stats;
+        while (!slot->tryRead(stats)) std::this_thread::yield();
+        if (stats.tradeCount > 0) snapshot.symbols.emplace_back(Symbol::fromId(id), stats);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return started == finished && updatesStarted_.load(std::memory_order_relaxed) == started;
+}
+
+std::shared_ptr<const StatsSnapshot> MarketDataStatsTracker::snapshot() const {
+    static constexpr int MAX_ATTEMPTS = 8;
+
+    auto cached = std::atomic_load(&cachedSnapshot_);
+    if (cached
+        && cached->version == updatesFinished_.load(std::memory_order_acquire)
+        && cached->version == updatesStarted_.load(std::memory_order_acquire)) {
+        return cached;
+    }
+
+    auto fresh = std::make_shared<StatsSnapshot>();
+    for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+        // The feed never paused long enough, so the last attempt reads through whatever is in flight
+        const bool last = attempt == MAX_ATTEMPTS - 1;
+        if (readAll(*fresh, last)) {
+            std::shared_ptr<const StatsSnapshot> published = std::move(fresh);
+            std::atomic_store(&cachedSnapshot_, published);
+            return published;
+        }
+        if (!last) std::this_thread::yield();
+    }
+
+    // Every symbol is filled in but batches may be split across symbols, so it is not cached
+    fresh->consistent = false;
+    return fresh;
+}
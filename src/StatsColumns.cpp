@@ -0,0 +1,120 @@
+#include "../include/StatsColumns.h"
+
+#if defined(STATS_COLUMNS_AVX2)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+    // Inputs are read through the raw pointers so the loop carries no vector bookkeeping
+    struct DerivedColumns {
+        const double* lastPrice;
+        const double* highPrice;
+        const double* lowPrice;
+        const double* volume;
+        const double* notional;
+        double* averagePrice;
+        double* range;
+        double* vwapDeviation;
+    };
+
+    void computeScalar(const DerivedColumns& columns, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const bool traded = columns.volume[i] > 0.0;
+            const double average = traded ? columns.notional[i] / columns.volume[i] : 0.0;
+            columns.averagePrice[i] = average;
+            columns.range[i] = traded ? columns.highPrice[i] - columns.lowPrice[i] : 0.0;
+            columns.vwapDeviation[i] = average > 0.0 ? (columns.lastPrice[i] - average) / average : 0.0;
+        }
+    }
+
+#if defined(STATS_COLUMNS_AVX2)
+    // Four symbols per iteration. Lanes without volume divide by zero and are then masked to 0,
+    // so the results match computeScalar bit for bit. Only this function is built for AVX2, the
+    // rest of the program keeps the baseline ISA and runs anywhere.
+    __attribute__((target("avx2")))
+    size_t computeAvx2(const DerivedColumns& columns, size_t count) {
+        const __m256d zero = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const __m256d volume = _mm256_loadu_pd(columns.volume + i);
+            const __m256d traded = _mm256_cmp_pd(volume, zero, _CMP_GT_OQ);
+
+            const __m256d average = _mm256_and_pd(_mm256_div_pd(_mm256_loadu_pd(columns.notional + i), volume), traded);
+            _mm256_storeu_pd(columns.averagePrice + i, average);
+
+            const __m256d range = _mm256_sub_pd(_mm256_loadu_pd(columns.highPrice + i), _mm256_loadu_pd(columns.lowPrice + i));
+            _mm256_storeu_pd(columns.range + i, _mm256_and_pd(range, traded));
+
+            const __m256d priced = _mm256_cmp_pd(average, zero, _CMP_GT_OQ);
+            const __m256d deviation = _mm256_div_pd(_mm256_sub_pd(_mm256_loadu_pd(columns.lastPrice + i), average), average);
+            _mm256_storeu_pd(columns.vwapDeviation + i, _mm256_and_pd(deviation, priced));
+        }
+        return i;
+    }
+#endif
+}
+
+bool StatsColumns::vectorized() {
+#if defined(STATS_COLUMNS_AVX2)
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+StatsColumns StatsColumns::fromSnapshot(const StatsSnapshot& snapshot) {
+    StatsColumns columns;
+    columns.version = snapshot.version;
+    columns.reserve(snapshot.symbols.size());
+    for (const auto& [symbol, stats] : snapshot.symbols) columns.add(symbol, stats);
+    return columns;
+}
+
+void StatsColumns::reserve(size_t count) {
+    symbols.reserve(count);
+    lastPrice.reserve(count);
+    highPrice.reserve(count);
+    lowPrice.reserve(count);
+    volume.reserve(count);
+    notional.reserve(count);
+}
+
+void StatsColumns::add(Symbol symbol, const SymbolStats& stats) {
+    symbols.push_back(symbol);
+    lastPrice.push_back(stats.lastPrice.toDouble());
+    highPrice.push_back(stats.highPrice.toDouble());
+    lowPrice.push_back(stats.lowPrice.toDouble());
+    volume.push_back(static_cast<double>(stats.totalVolume));
+    notional.push_back(stats.getTotalNotional());
+}
+
+void StatsColumns::computeDerived() {
+    averagePrice.resize(size());
+    range.resize(size());
+    vwapDeviation.resize(size());
+
+    const DerivedColumns columns{
+        lastPrice.data(), highPrice.data(), lowPrice.data(), volume.data(), notional.data(),
+        averagePrice.data(), range.data(), vwapDeviation.data()
+    };
+
+    size_t done = 0;
+#if defined(STATS_COLUMNS_AVX2)
+    if (vectorized()) done = computeAvx2(columns, size());
+#endif
+    computeScalar(columns, done, size());
+}
+
+void StatsColumns::computeDerivedScalar() {
+    averagePrice.resize(size());
+    range.resize(size());
+    vwapDeviation.resize(size());
+
+    computeScalar(DerivedColumns{
+        lastPrice.data(), highPrice.data(), lowPrice.data(), volume.data(), notional.data(),
+        averagePrice.data(), range.data(), vwapDeviation.data()
+    }, 0, size());
+}
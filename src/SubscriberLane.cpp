@@ -0,0 +1,148 @@
+#include "../include/SubscriberLane.h"
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+SubscriberLane::SubscriberLane(shared_ptr<IMarketDataSubscriber> subscriber, const SubscriptionOptions& options):
+    subscriber_(std::move(subscriber)),
+    mode_(options.deliveryMode),
+    lane_(
+        options.laneCapacity,
+        mode_ == DeliveryMode::CONFLATED ? OverflowPolicy::CONFLATE : options.overflowPolicy,
+        mode_ == DeliveryMode::CONFLATED || options.overflowPolicy == OverflowPolicy::CONFLATE
+            ? BoundedMessageQueue<LaneEntry, SymbolId>::KeyFunction([](const LaneEntry& entry) { return entry.message.symbol.id(); })
+            : nullptr,
+        mode_ == DeliveryMode::CONFLATED
+            ? BoundedMessageQueue<LaneEntry, SymbolId>::MergeFunction([](LaneEntry& pending, const LaneEntry& incoming) {
+                // Keep the oldest enqueue time so lag still reflects how long the symbol has been waiting
+                pending.message = incoming.message;
+                pending.accumulatedVolume += incoming.accumulatedVolume;
+                pending.messageCount += incoming.messageCount;
+            })
+            : nullptr
+    ),
+    waitStrategy_(options.waitStrategy),
+    running_(false)
+    {
+        if (!subscriber_) throw invalid_argument("Subscriber lane requires a subscriber");
+    }
+
+SubscriberLane::~SubscriberLane() {
+    stop();
+}
+
+// A dispatcher on an old subscriber snapshot can still reach a stopped lane. Those messages are
+// counted as dropped; a push that got in before stop() is drained by the lane thread before it exits.
+bool SubscriberLane::beginPush() {
+    pushing_.fetch_add(1);
+    if (running_.load()) return true;
+    pushing_.fetch_sub(1);
+    return false;
+}
+
+void SubscriberLane::onMarketData(const MarketDataMessage& message) {
+    if (!beginPush()) {
+        droppedAfterStop_.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+    lane_.push(LaneEntry{ message, chrono::steady_clock::now(), message.quantity, 1 });
+    pushing_.fetch_sub(1);
+}
+
+void SubscriberLane::onMarketDataBatch(Span<const MarketDataMessage> messages) {
+    if (!beginPush()) {
+        droppedAfterStop_.fetch_add(messages.size(), memory_order_relaxed);
+        return;
+    }
+
+    const auto enqueuedAt = chrono::steady_clock::now();
+    vector<LaneEntry> entries;
+    entries.reserve(messages.size());
+    for (const auto& message : messages) entries.push_back(LaneEntry{ message, enqueuedAt, message.quantity, 1 });
+    lane_.pushBatch(entries);
+    pushing_.fetch_sub(1);
+}
+
+void SubscriberLane::start() {
+    if (running_) return;
+    running_ = true;
+    lane_.reopen();
+    laneThread_ = thread(&SubscriberLane::laneLoop, this);
+}
+
+void SubscriberLane::stop() {
+    if (!running_) return;
+    running_ = false;
+    lane_.close(); // wake the lane thread so it drains and exits immediately
+
+    if (!laneThread_.joinable()) return;
+    // A subscriber that unsubscribes itself from its own callback cannot join its own thread,
+    // so the thread is detached and keeps the lane alive until its loop returns
+    if (laneThread_.get_id() == this_thread::get_id()) {
+        keepAlive_ = weak_from_this().lock();
+        laneThread_.detach();
+    }
+    else laneThread_.join();
+}
+
+void SubscriberLane::laneLoop() {
+    vector<LaneEntry> entries;
+    vector<MarketDataMessage> messages;
+    entries.reserve(MAX_DELIVERY_BATCH);
+    messages.reserve(MAX_DELIVERY_BATCH);
+
+    // pushing_ is checked before empty(), so a push that passed its running_ check is always seen
+    while (running_ || pushing_.load() > 0 || !lane_.empty()) {
+        entries.clear();
+        messages.clear();
+
+        LaneEntry first;
+        if (!waitStrategy_.waitPop(lane_, first)) continue;
+        entries.emplace_back(std::move(first));
+        lane_.drainTo(entries, MAX_DELIVERY_BATCH - 1);
+
+        // The oldest entry of the batch has waited longest, it defines the lag
+        const int64_t lag = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - entries.front().enqueuedAt).count();
+        lastLagNs_.store(lag, memory_order_relaxed);
+        if (lag > maxLagNs_.load(memory_order_relaxed)) maxLagNs_.store(lag, memory_order_relaxed);
+
+        deliver(entries, messages);
+        delivered_.fetch_add(entries.size(), memory_order_relaxed);
+    }
+
+    auto self = std::move(keepAlive_);
+}
+
+void SubscriberLane::deliver(vector<LaneEntry>& entries, vector<MarketDataMessage>& messages) {
+    if (mode_ == DeliveryMode::CONFLATED) {
+        for (auto& entry : entries) {
+            subscriber_->onConflatedMarketData(ConflatedMarketData{ std::move(entry.message), entry.accumulatedVolume, entry.messageCount });
+        }
+        return;
+    }
+
+    if (entries.size() == 1) {
+        subscriber_->onMarketData(entries.front().message);
+        return;
+    }
+    for (auto& entry : entries) messages.emplace_back(std::move(entry.message));
+    subscriber_->onMarketDataBatch(messages);
+}
+
+const shared_ptr<IMarketDataSubscriber>& SubscriberLane::getSubscriber() const {
+    return subscriber_;
+}
+
+SubscriberLaneStats SubscriberLane::getStats() const {
+    SubscriberLaneStats stats;
+    stats.queueDepth = lane_.size();
+    stats.delivered = delivered_.load(memory_order_relaxed);
+    stats.drops = lane_.getCounters();
+    stats.drops.droppedNewest += droppedAfterStop_.load(memory_order_relaxed);
+    stats.lastLag = chrono::nanoseconds(lastLagNs_.load(memory_order_relaxed));
+    stats.maxLag = chrono::nanoseconds(maxLagNs_.load(memory_order_relaxed));
+    return stats;
+}
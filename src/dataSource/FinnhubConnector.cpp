@@ -1,4 +1,6 @@
 #include "../../include/dataSource/FinnhubConnector.h"
+#include "../../include/LatencyHistogram.h"
+#include "../../include/MetricsRegistry.h"
 
 #include <iostream>
 #include <sstream>
@@ -13,7 +15,7 @@ using json = nlohmann::json;
 FinnhubConnector::FinnhubConnector(
     unique_ptr<IxWebSocketClient> wsClient,
     unique_ptr<FinnhubMarketDataParser> parser,
-    shared_ptr<ThreadSafeMessageQueue<MarketDataMessage>> messageQueue,
+    shared_ptr<MessageQueue<MarketDataMessage>> messageQueue,
     vector<string> symbols
 ):
     wsClient_(std::move(wsClient)),
@@ -84,6 +86,13 @@ void FinnhubConnector::tryConnect() {
     }
     if (wsClient_->isConnected()) return;
 
+    static Counter& reconnects = MetricsRegistry::instance().counter(
+        "dmhandler_finnhub_reconnects_total", "Connection attempts made after the first successful Finnhub connection");
+    static Counter& connectFailures = MetricsRegistry::instance().counter(
+        "dmhandler_finnhub_connect_failures_total", "Finnhub connection attempts that threw");
+
+    if (hasConnected_) reconnects.increment();
+
     try {
         cout << "[INFO] Attempting to connect to Finnhub WebSocket...\n";
         wsClient_->connect();
@@ -95,8 +104,10 @@ void FinnhubConnector::tryConnect() {
         }
         for (const auto& symbol : symbols) sendSubscribe(symbol);
 
+        hasConnected_ = true;
         cout << "[INFO] Successfully connected to Finnhub WebSocket.\n";
     } catch (const exception& e) {
+        connectFailures.increment();
         cerr << "[ERROR] Failed to connect to Finnhub WebSocket: " << e.what() << "\n";
     }
 }
@@ -122,17 +133,26 @@ void FinnhubConnector::sendSubscribe(const string& symbol) {
 }
 
 void FinnhubConnector::onMessageReceived(const string& message) {
+    static Counter& received = MetricsRegistry::instance().counter(
+        "dmhandler_messages_received_total", "Raw messages received from a data source", {{"source", "finnhub"}});
+
     if (!running_ || teardownRequested_) return;  // ignore messages after shutdown
+    received.increment();
     
     if (!parser_) {
         cerr << "[ERROR] Market data parser is not initialized.\n";
         return;
     }
 
+    const int64_t ingressNs = latencyClockNs();
+
     try {
         auto parsedMessage = parser_->parse(message);
         if (!parsedMessage.has_value()) return;
-        if (parsedMessage.has_value()) messageQueue_->push(parsedMessage.value());
+
+        parsedMessage->ingressNs = ingressNs;
+        parsedMessage->enqueueNs = latencyClockNs();
+        messageQueue_->push(parsedMessage.value());
     } catch (const exception& e) {
         cerr << "[ERROR] Failed to parse message: " << e.what() << "raw: " << message << "\n";
     }
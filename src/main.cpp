@@ -1,4 +1,6 @@
 #include "../include/MarketDataFeedHandler.h"
+#include "../include/BoundedMessageQueue.h"
+#include "../include/StatsColumns.h"
 
 #include "../include/testSubscribers/LoggingSubscriber.h"
 #include "../include/testSubscribers/FileLoggerSubscriber.h"
@@ -67,8 +69,8 @@ int main() {
     // Register parsers
     registerParsers();
 
-    // Shared queue and feed handler
-    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    // Shared bounded queue and feed handler, evicts the oldest ticks rather than growing without limit
+    auto queue = make_shared<BoundedMessageQueue<MarketDataMessage>>(1 << 16, OverflowPolicy::DROP_OLDEST);
     MarketDataFeedHandler feedHandler(queue);
 
     // Setup subscribers
@@ -84,7 +86,7 @@ int main() {
     feedHandler.start();
 
     // Start REST API server
-    auto restApi = make_unique<MarketDataRestApi>(feedHandler.getStatsTracker());
+    auto restApi = make_unique<MarketDataRestApi>(feedHandler.getStatsTracker(), feedHandler.getLatencyTracker());
     restApi->start(18080);
     cout << "[INFO] REST API server running on http://localhost:18080\n";
 
@@ -103,14 +105,19 @@ int main() {
     // Main loop — print stats every 1 minute
     while (!shutdownRequested.load(std::memory_order_relaxed)) {
         this_thread::sleep_for(chrono::seconds(60));
-        for (const auto& symbol : feedHandler.getStatsTracker()->getAllSymbols()) {
-            auto stats = feedHandler.getStatsTracker()->getStats(symbol);
+        auto snapshot = feedHandler.getStatsTracker()->snapshot();
+        auto columns = StatsColumns::fromSnapshot(*snapshot); // same order as the snapshot
+        columns.computeDerived();
+        for (size_t i = 0; i < snapshot->symbols.size(); ++i) {
+            const auto& [symbol, stats] = snapshot->symbols[i];
             cout << "[STATS] Symbol: " << symbol
-                 << ", Avg Price: " << stats.getAveragePrice()
+                 << ", Avg Price: " << columns.averagePrice[i]
                  << ", Total Volume: " << stats.totalVolume
                  << ", Last Price: " << stats.lastPrice
                  << ", Low Price: " << stats.lowPrice
                  << ", High Price: " << stats.highPrice
+                 << ", Range: " << columns.range[i]
+                 << ", VWAP Dev: " << columns.vwapDeviation[i]
                  << ", lastUpdate: " << chrono::duration_cast<chrono::seconds>(stats.lastUpdateTime.time_since_epoch()).count()
             << "\n";
         }
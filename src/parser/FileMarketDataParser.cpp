@@ -1,9 +1,12 @@
 #include "../../include/parser/FileMarketDataParser.h"
 #include "../../include/OrderSide.h"
+#include "../../include/MetricsRegistry.h"
 
 #include <sstream>
 #include <stdexcept>
 #include <chrono>
+#include <charconv>
+#include <system_error>
 
 using namespace std;
 
@@ -14,7 +17,15 @@ inline std::string trim(const std::string& s) {
     return s.substr(start, end - start + 1);
 }
 
-optional<MarketDataMessage> FileMarketDataParser::parse(const std::string& line) {
+template <typename Integer>
+static bool parseInteger(const std::string& text, Integer& value) {
+    const char* first = text.data();
+    const char* last = text.data() + text.size();
+    auto result = from_chars(first, last, value);
+    return result.ec == errc() && result.ptr == last && first != last;
+}
+
+static optional<MarketDataMessage> parseLine(const std::string& line) {
     istringstream iss(line);
 
     string symbol, sideStr, priceStr, sizeStr, timestampStr;
@@ -23,7 +34,7 @@ optional<MarketDataMessage> FileMarketDataParser::parse(const std::string& line)
     if (!getline(iss, sideStr, ','))    return nullopt;
     if (!getline(iss, priceStr, ','))   return nullopt;
     if (!getline(iss, sizeStr, ','))    return nullopt;
-    if (!getline(iss, timestampStr))    return nullopt;
+    if (!getline(iss, timestampStr, ',')) return nullopt; // anything after the timestamp is ignored
 
     // trim whitespace
     symbol = trim(symbol);
@@ -32,18 +43,35 @@ optional<MarketDataMessage> FileMarketDataParser::parse(const std::string& line)
     sizeStr = trim(sizeStr);
     timestampStr = trim(timestampStr);
 
+    // Prices are parsed straight into fixed point, integers with from_chars: no locale, no exceptions
+    auto price = Price::parse(priceStr);
+    if (!price) return nullopt;
+
+    int quantity = 0;
+    if (!parseInteger(sizeStr, quantity)) return nullopt;
+
+    long long nanos = 0;
+    if (!parseInteger(timestampStr, nanos)) return nullopt;
+
     try {
-        double price = stod(priceStr);
-        int quantity = stoi(sizeStr);
         OrderSide side = from_string(sideStr);
-        auto timestamp = chrono::system_clock::time_point(chrono::duration_cast<chrono::system_clock::duration>(chrono::nanoseconds(stoll(timestampStr))));
+        auto timestamp = chrono::system_clock::time_point(chrono::duration_cast<chrono::system_clock::duration>(chrono::nanoseconds(nanos)));
 
-        return MarketDataMessage{ symbol, side, price, quantity, timestamp };
+        return MarketDataMessage{ symbol, side, *price, quantity, timestamp };
     } catch (...) {
         return nullopt; // Return nullopt if any parsing error occurs
     }
 }
 
+optional<MarketDataMessage> FileMarketDataParser::parse(const std::string& line) {
+    static Counter& failures = MetricsRegistry::instance().counter(
+        "dmhandler_parse_failures_total", "Input rejected by a market data parser", {{"parser", "file"}});
+
+    auto message = parseLine(line);
+    if (!message) failures.increment();
+    return message;
+}
+
 optional<MarketDataMessage> FileMarketDataParser::parse(const MarketDataMessage& line) {
     // Pass-through or basic validation logic
     return line;
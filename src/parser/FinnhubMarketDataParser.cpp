@@ -1,5 +1,5 @@
 #include "../../include/parser/FinnhubMarketDataParser.h"
-
+#include "../../include/MetricsRegistry.h"
 
 #include <chrono>
 
@@ -7,6 +7,10 @@ using namespace std;
 using json = nlohmann::json;
 
 optional<MarketDataMessage> FinnhubMarketDataParser::parse(const std::string& line) {
+    // Pings and other non-trade frames are expected, only malformed JSON and unusable trades count
+    static Counter& failures = MetricsRegistry::instance().counter(
+        "dmhandler_parse_failures_total", "Input rejected by a market data parser", {{"parser", "finnhub"}});
+
     try {
         auto j = json::parse(line);
 
@@ -17,7 +21,7 @@ optional<MarketDataMessage> FinnhubMarketDataParser::parse(const std::string& li
                 MarketDataMessage msg;
 
                 msg.symbol = t.value("s", string());
-                msg.price = t.value("p", 0.0);
+                msg.price = t.value("p", 0.0); // JSON numbers arrive as double, rounding to the nearest millionth recovers the quoted decimal
                 msg.quantity = t.value("v", 0);
                 msg.side = OrderSide::UNKNOWN; // Finnhub does not provide side info
 
@@ -32,8 +36,11 @@ optional<MarketDataMessage> FinnhubMarketDataParser::parse(const std::string& li
 
                 return msg;
             }
+            failures.increment();
         }
-    } catch (...) { }
+    } catch (...) {
+        failures.increment();
+    }
 
     return nullopt;
 }
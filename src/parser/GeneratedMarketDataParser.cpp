@@ -1,5 +1,6 @@
 #include "../../include/parser/GeneratedMarketDataParser.h"
 #include "../../include/OrderSide.h"
+#include "../../include/MetricsRegistry.h"
 
 #include <sstream>
 #include <stdexcept>
@@ -16,7 +17,10 @@ inline std::string trim(const std::string& s) {
 }
 
 optional<MarketDataMessage> GeneratedMarketDataParser::parse(const string& line) {
-    // Pass-through or basic validation logic
+    // Generated data never arrives as text, anything routed here is rejected
+    static Counter& failures = MetricsRegistry::instance().counter(
+        "dmhandler_parse_failures_total", "Input rejected by a market data parser", {{"parser", "generated"}});
+    failures.increment();
     return nullopt;
 }
 
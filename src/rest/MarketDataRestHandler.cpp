@@ -1,14 +1,19 @@
 #include "../../include/rest/MarketDataRestHandler.h"
 
 #include <crow.h>
+#include <cstdlib>
 #include <sstream>
 #include <iomanip>
 
 using namespace std;
 
-MarketDataRestApi::MarketDataRestApi(std::shared_ptr<MarketDataStatsTracker> statsTracker): 
-    statsTracker_(std::move(statsTracker)), 
-    running_(false) 
+MarketDataRestApi::MarketDataRestApi(
+    std::shared_ptr<MarketDataStatsTracker> statsTracker,
+    std::shared_ptr<LatencyTracker> latencyTracker
+):
+    statsTracker_(std::move(statsTracker)),
+    latencyTracker_(std::move(latencyTracker)),
+    running_(false)
     { }
 
 MarketDataRestApi::~MarketDataRestApi() {
@@ -31,25 +36,173 @@ void MarketDataRestApi::stop() {
 }
 
 void MarketDataRestApi::runServer(uint16_t port) {
-    // Define a route for stats per symbol
+    // Define a route for stats per symbol, ?window=1m switches to a rolling window
     CROW_ROUTE(app_, "/stats/<string>")
-    ([this](const std::string& symbol){
+    ([this](const crow::request& request, const std::string& symbol){
+        crow::json::wvalue result;
+        result["symbol"] = symbol;
+
+        if (const char* window = request.url_params.get("window")) {
+            auto stats = statsTracker_->getWindowStats(symbol, window);
+            if (!stats) return crow::response(400, "Unknown window: " + std::string(window));
+
+            result["window"] = window;
+            result["vwap"] = stats->getVwap();
+            result["totalVolume"] = stats->totalVolume;
+            result["tradeCount"] = stats->tradeCount;
+            result["highPrice"] = stats->highPrice.toDouble();
+            result["lowPrice"] = stats->lowPrice.toDouble();
+            return crow::response(std::move(result));
+        }
+
         auto stats = statsTracker_->getStats(symbol);
 
         // JSON response with formatted stats
-        crow::json::wvalue result;
-        result["symbol"] = symbol;
-        result["lastPrice"] = stats.lastPrice;
+        result["lastPrice"] = stats.lastPrice.toDouble();
         result["totalVolume"] = stats.totalVolume;
         result["tradeCount"] = stats.tradeCount;
-        result["highPrice"] = stats.highPrice;
-        result["lowPrice"] = stats.lowPrice;
+        result["highPrice"] = stats.highPrice.toDouble();
+        result["lowPrice"] = stats.lowPrice.toDouble();
         result["averagePrice"] = stats.getAveragePrice();
+        result["priceStdDev"] = stats.getPriceStdDev();
+        result["realizedVolatility"] = stats.getRealizedVolatility();
+        result["tradeRate"] = stats.tradeRate;
+        result["buyVolume"] = stats.buyVolume;
+        result["sellVolume"] = stats.sellVolume;
+        result["buyCount"] = stats.buyCount;
+        result["sellCount"] = stats.sellCount;
+        result["buyNotional"] = stats.getBuyNotional();
+        result["sellNotional"] = stats.getSellNotional();
+        result["orderFlowImbalance"] = stats.getOrderFlowImbalance();
+
+        const auto ewmaNames = statsTracker_->getPriceEwmaNames();
+        auto& ewma = result["priceEwma"];
+        for (size_t i = 0; i < ewmaNames.size(); ++i) ewma[ewmaNames[i]] = stats.priceEwma[i];
+
+        if (auto quantiles = statsTracker_->getQuantiles(symbol)) {
+            auto& price = result["priceQuantiles"];
+            price["p5"] = quantiles->price.quantile(0.05);
+            price["p50"] = quantiles->price.quantile(0.50);
+            price["p95"] = quantiles->price.quantile(0.95);
+
+            auto& quantity = result["quantityQuantiles"];
+            quantity["p5"] = quantiles->quantity.quantile(0.05);
+            quantity["p50"] = quantiles->quantity.quantile(0.50);
+            quantity["p95"] = quantiles->quantity.quantile(0.95);
+        }
+
+        return crow::response(std::move(result));
+    });
+
+    // Every tracked symbol from one consistent snapshot
+    CROW_ROUTE(app_, "/stats")
+    ([this](){
+        auto snapshot = statsTracker_->snapshot();
+
+        crow::json::wvalue result;
+        result["version"] = snapshot->version;
+        result["consistent"] = snapshot->consistent;
+
+        std::vector<crow::json::wvalue> symbols;
+        symbols.reserve(snapshot->symbols.size());
+        for (const auto& [symbol, stats] : snapshot->symbols) {
+            crow::json::wvalue entry;
+            entry["symbol"] = symbol.str();
+            entry["lastPrice"] = stats.lastPrice.toDouble();
+            entry["totalVolume"] = stats.totalVolume;
+            entry["tradeCount"] = stats.tradeCount;
+            entry["highPrice"] = stats.highPrice.toDouble();
+            entry["lowPrice"] = stats.lowPrice.toDouble();
+            entry["averagePrice"] = stats.getAveragePrice();
+            symbols.push_back(std::move(entry));
+        }
+        result["symbols"] = std::move(symbols);
 
         return result;
     });
 
+    // Top symbols by volume, trades, notional or change, e.g. /leaders?by=volume&n=20
+    CROW_ROUTE(app_, "/leaders")
+    ([this](const crow::request& request){
+        const char* by = request.url_params.get("by");
+        auto metric = leaderboardMetricFromString(by ? by : "volume");
+        if (!metric) return crow::response(400, "Unknown leaderboard: " + std::string(by));
+
+        size_t n = 10;
+        if (const char* count = request.url_params.get("n")) {
+            char* end = nullptr;
+            const unsigned long parsed = std::strtoul(count, &end, 10);
+            if (end == count || *end != '\0') return crow::response(400, "Invalid n: " + std::string(count));
+            n = parsed;
+        }
+
+        crow::json::wvalue result;
+        result["by"] = to_string(*metric);
+
+        std::vector<crow::json::wvalue> leaders;
+        for (const auto& entry : statsTracker_->getLeaders(*metric, n)) {
+            crow::json::wvalue leader;
+            leader["symbol"] = entry.symbol.str();
+            leader["value"] = entry.value;
+            leaders.push_back(std::move(leader));
+        }
+        result["leaders"] = std::move(leaders);
+
+        return crow::response(std::move(result));
+    });
+
+    // Per-stage latency percentiles in nanoseconds
+    CROW_ROUTE(app_, "/latency")
+    ([this](){
+        if (!latencyTracker_) return crow::response(404);
+
+        crow::json::wvalue result;
+        for (size_t i = 0; i < LatencyTracker::STAGE_COUNT; ++i) {
+            const auto stage = static_cast<LatencyStage>(i);
+            const auto summary = latencyTracker_->getSummary(stage);
+
+            auto& entry = result[to_string(stage)];
+            entry["count"] = summary.count;
+            entry["p50Ns"] = summary.p50Ns;
+            entry["p99Ns"] = summary.p99Ns;
+            entry["p999Ns"] = summary.p999Ns;
+            entry["maxNs"] = summary.maxNs;
+            entry["meanNs"] = summary.meanNs;
+        }
+
+        return crow::response(std::move(result));
+    });
+
+    // Every registered counter and gauge plus the stage latencies, in Prometheus text format
+    CROW_ROUTE(app_, "/metrics")
+    ([this](){
+        crow::response response(renderMetrics());
+        response.set_header("Content-Type", "text/plain; version=0.0.4");
+        return response;
+    });
+
     app_.port(port).multithreaded().run();
 
     running_ = false;
-}
\ No newline at end of file
+}
+
+string MarketDataRestApi::renderMetrics() const {
+    string text = MetricsRegistry::instance().renderPrometheus();
+    if (!latencyTracker_) return text;
+
+    ostringstream out;
+    out << "# HELP dmhandler_latency_seconds Time spent per pipeline stage\n";
+    out << "# TYPE dmhandler_latency_seconds summary\n";
+    for (size_t i = 0; i < LatencyTracker::STAGE_COUNT; ++i) {
+        const auto stage = static_cast<LatencyStage>(i);
+        const auto summary = latencyTracker_->getSummary(stage);
+        const string label = "stage=\"" + to_string(stage) + "\"";
+
+        out << "dmhandler_latency_seconds{" << label << ",quantile=\"0.5\"} " << summary.p50Ns * 1e-9 << "\n";
+        out << "dmhandler_latency_seconds{" << label << ",quantile=\"0.99\"} " << summary.p99Ns * 1e-9 << "\n";
+        out << "dmhandler_latency_seconds{" << label << ",quantile=\"0.999\"} " << summary.p999Ns * 1e-9 << "\n";
+        out << "dmhandler_latency_seconds_sum{" << label << "} " << summary.meanNs * summary.count * 1e-9 << "\n";
+        out << "dmhandler_latency_seconds_count{" << label << "} " << summary.count << "\n";
+    }
+    return text + out.str();
+}
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include "../include/BarBuilder.h"
+#include "../include/MarketDataFeedHandler.h"
+#include "../include/ThreadSafeMessageQueue.h"
+
+#include "tests_helper.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono_literals;
+
+class RecordingBarSubscriber : public IBarSubscriber {
+public:
+    mutex mtx;
+    vector<pair<Bar, string>> bars;
+
+    void onBar(const Bar& bar, const BarSpec& spec) override {
+        lock_guard<mutex> lock(mtx);
+        bars.emplace_back(bar, spec.name);
+    }
+};
+
+static BarBuilderConfig onlySpec(const BarSpec& spec, size_t history = 1024) {
+    BarBuilderConfig config;
+    config.specs = { spec };
+    config.history = history;
+    return config;
+}
+
+TEST(BarBuilderTest, BuildsTimeBarsOnBoundaries) {
+    BarBuilder builder(onlySpec(BarSpec::time("1s", 1s)));
+    auto subscriber = make_shared<RecordingBarSubscriber>();
+    builder.subscribe(subscriber);
+
+    builder.onMarketData(makeMessage("BAR1", 100.0, 10, 100ms));
+    builder.onMarketData(makeMessage("BAR1", 105.0, 5, 400ms));
+    builder.onMarketData(makeMessage("BAR1", 98.0, 20, 900ms));
+    EXPECT_TRUE(subscriber->bars.empty());
+
+    builder.onMarketData(makeMessage("BAR1", 101.0, 1, 1200ms)); // crosses into the next second
+
+    ASSERT_EQ(subscriber->bars.size(), 1);
+    const Bar& bar = subscriber->bars[0].first;
+    EXPECT_EQ(subscriber->bars[0].second, "1s");
+    EXPECT_EQ(bar.symbol, "BAR1");
+    EXPECT_EQ(bar.openTime, TEST_EPOCH);
+    EXPECT_EQ(bar.closeTime, TEST_EPOCH + 1s);
+    EXPECT_EQ(bar.open, 100.0);
+    EXPECT_EQ(bar.high, 105.0);
+    EXPECT_EQ(bar.low, 98.0);
+    EXPECT_EQ(bar.close, 98.0);
+    EXPECT_EQ(bar.volume, 35);
+    EXPECT_EQ(bar.tradeCount, 3);
+    EXPECT_DOUBLE_EQ(bar.getVwap(), (100.0 * 10 + 105.0 * 5 + 98.0 * 20) / 35);
+
+    auto current = builder.getCurrentBar("BAR1", "1s");
+    ASSERT_TRUE(current.has_value());
+    EXPECT_EQ(current->openTime, TEST_EPOCH + 1s);
+    EXPECT_EQ(current->tradeCount, 1);
+}
+
+TEST(BarBuilderTest, LateTradeFoldsIntoOpenBar) {
+    BarBuilder builder(onlySpec(BarSpec::time("1s", 1s)));
+    builder.onMarketData(makeMessage("BAR2", 100.0, 1, 1500ms));
+    builder.onMarketData(makeMessage("BAR2", 90.0, 1, 900ms));
+
+    EXPECT_TRUE(builder.getBars("BAR2", "1s").empty());
+    EXPECT_EQ(builder.getCurrentBar("BAR2", "1s")->tradeCount, 2);
+    EXPECT_EQ(builder.getCurrentBar("BAR2", "1s")->low, 90.0);
+}
+
+TEST(BarBuilderTest, CloseElapsedFlushesQuietSymbols) {
+    BarBuilder builder(onlySpec(BarSpec::time("1m", 60s)));
+    builder.onMarketData(makeMessage("BAR3", 100.0, 1, 10s));
+
+    builder.closeElapsed(TEST_EPOCH + 59s);
+    EXPECT_TRUE(builder.getBars("BAR3", "1m").empty());
+
+    builder.closeElapsed(TEST_EPOCH + 60s);
+    ASSERT_EQ(builder.getBars("BAR3", "1m").size(), 1);
+    EXPECT_FALSE(builder.getCurrentBar("BAR3", "1m").has_value());
+}
+
+TEST(BarBuilderTest, BuildsTickBars) {
+    BarBuilder builder(onlySpec(BarSpec::ticks("3t", 3)));
+    for (int i = 0; i < 10; ++i) builder.onMarketData(makeMessage("BAR4", 100.0 + i, 1, chrono::milliseconds(i)));
+
+    auto bars = builder.getBars("BAR4", "3t");
+    ASSERT_EQ(bars.size(), 3);
+    EXPECT_EQ(bars[0].open, 100.0);
+    EXPECT_EQ(bars[0].close, 102.0);
+    EXPECT_EQ(bars[2].open, 106.0);
+    EXPECT_EQ(bars[2].closeTime, TEST_EPOCH + 8ms);
+    for (const auto& bar : bars) EXPECT_EQ(bar.tradeCount, 3);
+    EXPECT_EQ(builder.getCurrentBar("BAR4", "3t")->tradeCount, 1);
+}
+
+TEST(BarBuilderTest, BuildsVolumeBarsWithoutSplittingTrades) {
+    BarBuilder builder(onlySpec(BarSpec::volume("100v", 100)));
+    builder.onMarketData(makeMessage("BAR5", 10.0, 60, 0ms));
+    builder.onMarketData(makeMessage("BAR5", 11.0, 70, 1ms));  // closes at 130 shares
+    builder.onMarketData(makeMessage("BAR5", 12.0, 100, 2ms)); // one trade fills a bar on its own
+
+    auto bars = builder.getBars("BAR5", "100v");
+    ASSERT_EQ(bars.size(), 2);
+    EXPECT_EQ(bars[0].volume, 130);
+    EXPECT_EQ(bars[0].tradeCount, 2);
+    EXPECT_EQ(bars[1].volume, 100);
+    EXPECT_EQ(bars[1].open, 12.0);
+    EXPECT_FALSE(builder.getCurrentBar("BAR5", "100v").has_value());
+}
+
+TEST(BarBuilderTest, HistoryRingKeepsNewestBars) {
+    BarBuilder builder(onlySpec(BarSpec::ticks("1t", 1), 4));
+    for (int i = 0; i < 10; ++i) builder.onMarketData(makeMessage("BAR6", 100.0 + i, 1, chrono::milliseconds(i)));
+
+    auto bars = builder.getBars("BAR6", "1t");
+    ASSERT_EQ(bars.size(), 4);
+    for (int i = 0; i < 4; ++i) EXPECT_EQ(bars[i].close, 106.0 + i);
+
+    auto lastTwo = builder.getBars("BAR6", "1t", 2);
+    ASSERT_EQ(lastTwo.size(), 2);
+    EXPECT_EQ(lastTwo[0].close, 108.0);
+    EXPECT_EQ(lastTwo[1].close, 109.0);
+
+    EXPECT_TRUE(builder.getBars("BAR6", "5m").empty());
+    EXPECT_TRUE(builder.getBars("NOT_A_SYMBOL", "1t").empty());
+}
+
+TEST(BarBuilderTest, EverySpecRunsSideBySide) {
+    BarBuilderConfig config;
+    config.specs = { BarSpec::time("1s", 1s), BarSpec::ticks("2t", 2), BarSpec::volume("10v", 10) };
+    BarBuilder builder(config);
+    auto subscriber = make_shared<RecordingBarSubscriber>();
+    builder.subscribe(subscriber);
+
+    builder.onMarketData(makeMessage("BAR7", 100.0, 5, 0ms));
+    builder.onMarketData(makeMessage("BAR7", 100.0, 5, 1500ms));
+
+    ASSERT_EQ(subscriber->bars.size(), 3);
+    EXPECT_EQ(subscriber->bars[0].second, "1s");
+    EXPECT_EQ(subscriber->bars[1].second, "2t");
+    EXPECT_EQ(subscriber->bars[2].second, "10v");
+
+    builder.unsubscribe(subscriber);
+    builder.onMarketData(makeMessage("BAR7", 100.0, 10, 2500ms));
+    EXPECT_EQ(subscriber->bars.size(), 3);
+}
+
+TEST(BarBuilderTest, SubscriberMayReadHistoryFromCallback) {
+    BarBuilder builder(onlySpec(BarSpec::ticks("1t", 1)));
+
+    class HistoryReader : public IBarSubscriber {
+    public:
+        BarBuilder* builder = nullptr;
+        size_t seen = 0;
+        void onBar(const Bar& bar, const BarSpec& spec) override {
+            seen = builder->getBars(bar.symbol, spec.name).size();
+        }
+    };
+
+    auto reader = make_shared<HistoryReader>();
+    reader->builder = &builder;
+    builder.subscribe(reader);
+    builder.onMarketData(makeMessage("BAR8", 100.0, 1, 0ms));
+    builder.onMarketData(makeMessage("BAR8", 100.0, 1, 1ms));
+    EXPECT_EQ(reader->seen, 2);
+}
+
+TEST(BarBuilderTest, RejectsBadConfig) {
+    EXPECT_THROW(BarBuilder(onlySpec(BarSpec::ticks("0t", 0))), invalid_argument);
+    EXPECT_THROW(BarBuilder(onlySpec(BarSpec::ticks("1t", 1), 0)), invalid_argument);
+
+    BarBuilderConfig duplicate;
+    duplicate.specs = { BarSpec::ticks("x", 1), BarSpec::volume("x", 1) };
+    EXPECT_THROW(BarBuilder builder(duplicate), invalid_argument);
+
+    BarBuilderConfig empty;
+    empty.specs.clear();
+    EXPECT_THROW(BarBuilder builder(empty), invalid_argument);
+}
+
+TEST(BarBuilderTest, BuildsBarsFromFeedHandler) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandler handler(queue);
+    auto builder = make_shared<BarBuilder>(onlySpec(BarSpec::ticks("10t", 10)));
+    handler.subscribe(builder);
+    handler.start();
+
+    for (int i = 0; i < 100; ++i) queue->push(makeMessage(i % 2 ? "BAR9" : "BAR10", 100.0, 1, chrono::milliseconds(i)));
+
+    auto deadline = chrono::steady_clock::now() + 5s;
+    while (builder->getBars("BAR10", "10t").size() < 5 && chrono::steady_clock::now() < deadline) this_thread::sleep_for(1ms);
+    handler.stop();
+
+    EXPECT_EQ(builder->getBars("BAR9", "10t").size(), 5);
+    EXPECT_EQ(builder->getBars("BAR10", "10t").size(), 5);
+}
@@ -0,0 +1,263 @@
+#include <gtest/gtest.h>
+#include "../include/BoundedMessageQueue.h"
+#include "../include/MarketDataFeedHandler.h"
+
+#include "tests_helper.h"
+
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+TEST(BoundedMessageQueueTest, ZeroCapacityThrows) {
+    EXPECT_THROW(BoundedMessageQueue<int> queue(0), invalid_argument);
+}
+
+TEST(BoundedMessageQueueTest, ConflateRequiresKeyFunction) {
+    EXPECT_THROW((BoundedMessageQueue<int, int>(4, OverflowPolicy::CONFLATE)), invalid_argument);
+}
+
+TEST(BoundedMessageQueueTest, PushAndPopInOrder) {
+    BoundedMessageQueue<int> queue(4);
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_EQ(queue.pop(), 1);
+
+    int value = 0;
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 2);
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 3);
+    EXPECT_FALSE(queue.tryPop(value));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(BoundedMessageQueueTest, DropNewestWhenFull) {
+    BoundedMessageQueue<int> queue(2, OverflowPolicy::DROP_NEWEST);
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+
+    EXPECT_EQ(queue.size(), 2);
+    EXPECT_EQ(queue.pop(), 1);
+    EXPECT_EQ(queue.pop(), 2);
+
+    auto counters = queue.getCounters();
+    EXPECT_EQ(counters.pushed, 2);
+    EXPECT_EQ(counters.droppedNewest, 1);
+    EXPECT_EQ(counters.totalDropped(), 1);
+    EXPECT_EQ(counters.highWatermark, 2);
+}
+
+TEST(BoundedMessageQueueTest, DropOldestWhenFull) {
+    BoundedMessageQueue<int> queue(2, OverflowPolicy::DROP_OLDEST);
+    for (int i = 1; i <= 5; ++i) queue.push(i);
+
+    EXPECT_EQ(queue.size(), 2);
+    EXPECT_EQ(queue.pop(), 4);
+    EXPECT_EQ(queue.pop(), 5);
+    EXPECT_EQ(queue.getCounters().droppedOldest, 3);
+}
+
+TEST(BoundedMessageQueueTest, DrainToReleasesBlockedProducers) {
+    BoundedMessageQueue<int> queue(2, OverflowPolicy::BLOCK);
+    queue.push(1);
+    queue.push(2);
+
+    thread producer([&queue]() {
+        queue.push(3);
+        queue.push(4);
+    });
+
+    vector<int> batch;
+    while (batch.size() < 4) queue.drainTo(batch, 2);
+    producer.join();
+
+    EXPECT_EQ(batch, (vector<int>{1, 2, 3, 4}));
+}
+
+TEST(BoundedMessageQueueTest, BlockWaitsForConsumer) {
+    BoundedMessageQueue<int> queue(1, OverflowPolicy::BLOCK);
+    queue.push(1);
+
+    atomic<bool> pushed{false};
+    thread producer([&]() {
+        queue.push(2);
+        pushed = true;
+    });
+
+    this_thread::sleep_for(chrono::milliseconds(50));
+    EXPECT_FALSE(pushed.load());
+
+    EXPECT_EQ(queue.pop(), 1);
+    producer.join();
+    EXPECT_TRUE(pushed.load());
+    EXPECT_EQ(queue.pop(), 2);
+    EXPECT_EQ(queue.getCounters().totalDropped(), 0);
+}
+
+TEST(BoundedMessageQueueTest, CloseReleasesBlockedProducersAndConsumers) {
+    BoundedMessageQueue<int> full(1, OverflowPolicy::BLOCK);
+    full.push(1);
+    thread producer([&full]() { full.push(2); });
+
+    BoundedMessageQueue<int> empty(1);
+    thread consumer([&empty]() {
+        int value = 0;
+        EXPECT_FALSE(empty.waitPop(value, chrono::seconds(10)));
+    });
+
+    this_thread::sleep_for(chrono::milliseconds(50));
+    full.close();
+    empty.close();
+    producer.join();
+    consumer.join();
+
+    EXPECT_EQ(full.size(), 1);
+    EXPECT_EQ(full.getCounters().droppedNewest, 1);
+}
+
+TEST(BoundedMessageQueueTest, ConflatesBySymbol) {
+    BoundedMessageQueue<MarketDataMessage> queue(
+        4,
+        OverflowPolicy::CONFLATE,
+        [](const MarketDataMessage& message) { return message.symbol; }
+    );
+
+    queue.push(makeMessage("AAPL", 150.0, 10));
+    queue.push(makeMessage("MSFT", 300.0, 20));
+    queue.push(makeMessage("AAPL", 151.0, 30));
+
+    EXPECT_EQ(queue.size(), 2);
+    EXPECT_EQ(queue.getCounters().conflated, 1);
+
+    MarketDataMessage msg;
+    ASSERT_TRUE(queue.tryPop(msg));
+    EXPECT_EQ(msg.symbol, "AAPL");
+    EXPECT_DOUBLE_EQ(msg.price, 151.0); // latest value, original position
+    ASSERT_TRUE(queue.tryPop(msg));
+    EXPECT_EQ(msg.symbol, "MSFT");
+
+    // Once popped, a new message for the symbol is queued rather than conflated
+    queue.push(makeMessage("AAPL", 152.0, 5));
+    EXPECT_EQ(queue.size(), 1);
+    EXPECT_EQ(queue.getCounters().conflated, 1);
+}
+
+TEST(BoundedMessageQueueTest, ConflateDropsUnknownKeyWhenFull) {
+    BoundedMessageQueue<MarketDataMessage> queue(
+        1,
+        OverflowPolicy::CONFLATE,
+        [](const MarketDataMessage& message) { return message.symbol; }
+    );
+
+    queue.push(makeMessage("AAPL", 150.0, 10));
+    queue.push(makeMessage("TSLA", 250.0, 10));
+
+    EXPECT_EQ(queue.size(), 1);
+    EXPECT_EQ(queue.getCounters().droppedNewest, 1);
+}
+
+TEST(BoundedMessageQueueTest, MultiProducerMultiConsumerStressTest) {
+    BoundedMessageQueue<int> queue(64, OverflowPolicy::BLOCK);
+
+    const int numThreads = 8;
+    const int numMessages = 5000;
+    atomic<int> totalPopped{0};
+    atomic<long long> sum{0};
+
+    vector<thread> producers;
+    vector<thread> consumers;
+
+    for (int i = 0; i < numThreads; ++i) {
+        producers.emplace_back([&queue, i]() {
+            for (int j = 0; j < numMessages; ++j) queue.push(i * numMessages + j);
+        });
+    }
+
+    for (int i = 0; i < numThreads; ++i) {
+        consumers.emplace_back([&]() {
+            for (int j = 0; j < numMessages; ++j) {
+                sum += queue.pop();
+                ++totalPopped;
+            }
+        });
+    }
+
+    for (auto& producer : producers) producer.join();
+    for (auto& consumer : consumers) consumer.join();
+
+    const long long total = static_cast<long long>(numThreads) * numMessages;
+    EXPECT_EQ(totalPopped.load(), total);
+    EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_LE(queue.getCounters().highWatermark, 64);
+}
+
+TEST(BoundedMessageQueueTest, FeedsMarketDataFeedHandler) {
+    auto queue = make_shared<BoundedMessageQueue<MarketDataMessage>>(128, OverflowPolicy::DROP_OLDEST);
+    MarketDataFeedHandler handler(queue);
+    handler.start();
+
+    for (int i = 0; i < 50; ++i) queue->push(makeMessage("JPM", 150.0 + i, 10));
+
+    this_thread::sleep_for(chrono::milliseconds(200));
+    handler.stop();
+
+    EXPECT_EQ(handler.getStatsTracker()->getStats("JPM").tradeCount, 50);
+}
+
+TEST(BoundedMessageQueueTest, PushBatchAppliesOverflowPolicy) {
+    BoundedMessageQueue<int> queue(3, OverflowPolicy::DROP_OLDEST);
+    vector<int> items = {1, 2, 3, 4, 5};
+    queue.pushBatch(items);
+
+    EXPECT_EQ(queue.popBatch(10), (vector<int>{3, 4, 5}));
+    EXPECT_EQ(queue.getCounters().droppedOldest, 2);
+}
+
+TEST(BoundedMessageQueueTest, BlockingPushBatchLargerThanCapacity) {
+    BoundedMessageQueue<int> queue(4, OverflowPolicy::BLOCK);
+    vector<int> items(100);
+    for (int i = 0; i < 100; ++i) items[i] = i;
+
+    // The consumer sleeps in pop(), the batch must wake it before waiting for space
+    vector<int> received;
+    thread consumer([&]() {
+        for (int i = 0; i < 100; ++i) received.push_back(queue.pop());
+    });
+
+    queue.pushBatch(items);
+    consumer.join();
+
+    EXPECT_EQ(received, items);
+    EXPECT_EQ(queue.getCounters().totalDropped(), 0);
+}
+
+TEST(BoundedMessageQueueTest, ConflateMergesWithMergeFunction) {
+    BoundedMessageQueue<MarketDataMessage> queue(
+        4,
+        OverflowPolicy::CONFLATE,
+        [](const MarketDataMessage& message) { return message.symbol; },
+        [](MarketDataMessage& pending, const MarketDataMessage& incoming) {
+            pending.price = incoming.price;
+            pending.quantity += incoming.quantity;
+        }
+    );
+
+    queue.push(makeMessage("AAPL", 150.0, 10));
+    queue.push(makeMessage("AAPL", 151.0, 20));
+    queue.push(makeMessage("AAPL", 152.0, 30));
+
+    MarketDataMessage msg;
+    ASSERT_TRUE(queue.tryPop(msg));
+    EXPECT_DOUBLE_EQ(msg.price, 152.0);
+    EXPECT_EQ(msg.quantity, 60);
+    EXPECT_EQ(queue.getCounters().conflated, 2);
+}
@@ -4,6 +4,7 @@
 #include "parser/FinnhubMarketDataParser.h"
 #include "dataSource/FinnhubConnector.h"
 #include "ThreadSafeMessageQueue.h"
+#include "BoundedMessageQueue.h"
 #include <chrono>
 #include <thread>
 
@@ -636,3 +637,45 @@ TEST_F(FinnhubConnectorTest, HandlesWebSocketClientDisconnection) {
     ASSERT_TRUE(queue->empty());
 }
 
+
+TEST_F(FinnhubConnectorTest, PushesIntoBoundedQueueWithOverflowPolicy) {
+    auto queue = std::make_shared<BoundedMessageQueue<MarketDataMessage>>(1, OverflowPolicy::DROP_NEWEST);
+    auto mockWsClient = std::make_unique<MockWebSocketClient>();
+    auto parser = std::make_unique<FinnhubMarketDataParser>();
+
+    EXPECT_CALL(*mockWsClient, isConnected())
+        .WillOnce(Return(false))
+        .WillRepeatedly(Return(true));
+
+    EXPECT_CALL(*mockWsClient, connect())
+        .Times(AtLeast(1));
+
+    EXPECT_CALL(*mockWsClient, send(_))
+        .Times(AtLeast(1));
+
+    MockWebSocketClient::MessageCallBack callback;
+    EXPECT_CALL(*mockWsClient, setMessageCallBack(_))
+        .WillOnce(Invoke([&](MockWebSocketClient::MessageCallBack cb) {
+            callback = cb;
+        }));
+
+    FinnhubConnector connector(
+        std::move(mockWsClient),
+        std::move(parser),
+        queue,
+        {"AAPL"}
+    );
+
+    connector.start();
+    waitForConnectionAttempts();
+
+    if (callback) {
+        callback(R"({"type":"trade","data":[{"s":"AAPL","p":150.25,"v":100,"t":1640995200000}]})");
+        callback(R"({"type":"trade","data":[{"s":"AAPL","p":150.50,"v":200,"t":1640995200001}]})");
+    }
+
+    connector.stop();
+
+    EXPECT_EQ(queue->size(), 1);
+    EXPECT_EQ(queue->getCounters().droppedNewest, 1);
+}
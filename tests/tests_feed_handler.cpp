@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "../include/MarketDataFeedHandler.h"
+#include "../include/SpscRingBuffer.h"
 #include "../include/parser/MarketDataParserRegistry.h"
 #include "../include/parser/FileMarketDataParser.h"
 #include "../include/parser/GeneratedMarketDataParser.h"
@@ -9,7 +10,7 @@
 #include "../include/testSubscribers/MarketStatsDataSubscriber.h"
 #include "../include/rest/MarketDataRestHandler.h"
 
-#include "tests_helper.h"
+#include "tests_http_helper.h"
 
 #include <curl/curl.h>
 #include <memory>
@@ -18,6 +19,9 @@
 #include <random>
 #include <regex>
 #include <cmath>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace std;
 
@@ -451,4 +455,501 @@ TEST_F(MarketDataFeedHandlerTest, SimulatorParserIntegrationTest) {
     EXPECT_GT(messageCount.load(), 0);
     
     EXPECT_NO_THROW(feedHandler->unsubscribe(loggingSubscriber));
-}
\ No newline at end of file
+}
+class CountingSubscriber : public IMarketDataSubscriber {
+public:
+    atomic<int> received{0};
+
+    void onMarketData(const MarketDataMessage& message) override {
+        received++;
+    }
+};
+
+TEST(MarketDataFeedHandlerQueueTest, DispatchesFromSpscRingBuffer) {
+    auto ringBuffer = make_shared<SpscRingBuffer<MarketDataMessage>>(256);
+    MarketDataFeedHandler handler(ringBuffer);
+    auto countingSubscriber = make_shared<CountingSubscriber>();
+    handler.subscribe(countingSubscriber);
+    handler.start();
+
+    for (int i = 0; i < 100; ++i) {
+        ringBuffer->push(MarketDataMessage{
+            .symbol = "NVDA",
+            .side = OrderSide::BUY,
+            .price = 400.0 + i,
+            .quantity = 1 + i,
+            .timestamp = chrono::system_clock::now()
+        });
+    }
+
+    this_thread::sleep_for(200ms); // Allow some time for the messages to be processed
+    handler.stop();
+
+    EXPECT_EQ(countingSubscriber->received.load(), 100);
+    EXPECT_EQ(handler.getStatsTracker()->getStats("NVDA").tradeCount, 100);
+}
+
+TEST(MarketDataFeedHandlerQueueTest, WakesImmediatelyAfterIdleGap) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandler handler(queue);
+    auto countingSubscriber = make_shared<CountingSubscriber>();
+    handler.subscribe(countingSubscriber);
+    handler.start();
+
+    this_thread::sleep_for(300ms); // let the dispatcher block on the empty queue
+
+    queue->push(MarketDataMessage{
+        .symbol = "META",
+        .side = OrderSide::SELL,
+        .price = 480.0,
+        .quantity = 10,
+        .timestamp = chrono::system_clock::now()
+    });
+
+    auto deadline = chrono::steady_clock::now() + 2s;
+    while (countingSubscriber->received.load() == 0 && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::microseconds(100));
+    }
+    EXPECT_EQ(countingSubscriber->received.load(), 1);
+
+    // stop() must not wait out the idle timeout
+    auto stopStart = chrono::steady_clock::now();
+    handler.stop();
+    EXPECT_LT(chrono::steady_clock::now() - stopStart, 1s);
+}
+
+TEST(MarketDataFeedHandlerQueueTest, DispatchesWithEveryWaitStrategy) {
+    for (const auto& strategy : {WaitStrategy::busySpin(), WaitStrategy::spinYield(), WaitStrategy::spinPark()}) {
+        auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+        MarketDataFeedHandlerConfig config;
+        config.waitStrategy = strategy;
+        config.maxBatchSize = 8;
+
+        MarketDataFeedHandler handler(queue, config);
+        auto countingSubscriber = make_shared<CountingSubscriber>();
+        handler.subscribe(countingSubscriber);
+        handler.start();
+
+        for (int i = 0; i < 50; ++i) {
+            queue->push(MarketDataMessage{
+                .symbol = "AMD",
+                .side = OrderSide::BUY,
+                .price = 120.0 + i,
+                .quantity = 10,
+                .timestamp = chrono::system_clock::now()
+            });
+        }
+
+        auto deadline = chrono::steady_clock::now() + 5s;
+        while (countingSubscriber->received.load() < 50 && chrono::steady_clock::now() < deadline) {
+            this_thread::sleep_for(1ms);
+        }
+        handler.stop();
+
+        EXPECT_EQ(countingSubscriber->received.load(), 50) << to_string(strategy.mode);
+    }
+}
+
+TEST(MarketDataFeedHandlerQueueTest, RejectsZeroBatchSize) {
+    MarketDataFeedHandlerConfig config;
+    config.maxBatchSize = 0;
+    EXPECT_THROW(MarketDataFeedHandler(make_shared<ThreadSafeMessageQueue<MarketDataMessage>>(), config), invalid_argument);
+}
+
+class ShardRecordingSubscriber : public IMarketDataSubscriber {
+public:
+    mutex recordMutex;
+    unordered_map<string, vector<int>> quantitiesBySymbol;
+    unordered_map<string, set<thread::id>> threadsBySymbol;
+    atomic<int> received{0};
+
+    void onMarketData(const MarketDataMessage& message) override {
+        {
+            lock_guard<mutex> lock(recordMutex);
+            quantitiesBySymbol[message.symbol].push_back(message.quantity);
+            threadsBySymbol[message.symbol].insert(this_thread::get_id());
+        }
+        received++;
+    }
+};
+
+TEST(MarketDataFeedHandlerShardTest, ShardForIsStableAndInRange) {
+    EXPECT_EQ(MarketDataFeedHandler::shardFor("AAPL", 4), MarketDataFeedHandler::shardFor("AAPL", 4));
+    EXPECT_EQ(MarketDataFeedHandler::shardFor("AAPL", 1), 0);
+
+    set<size_t> usedShards;
+    for (const string symbol : {"AAPL", "GOOGL", "MSFT", "AMZN", "TSLA", "NFLX", "NVDA", "META", "JPM", "V", "UNH", "BRK.A"}) {
+        size_t shard = MarketDataFeedHandler::shardFor(symbol, 4);
+        EXPECT_LT(shard, 4);
+        usedShards.insert(shard);
+    }
+    EXPECT_GT(usedShards.size(), 1);
+}
+
+TEST(MarketDataFeedHandlerShardTest, RejectsZeroShards) {
+    MarketDataFeedHandlerConfig config;
+    config.shardCount = 0;
+    EXPECT_THROW(MarketDataFeedHandler(make_shared<ThreadSafeMessageQueue<MarketDataMessage>>(), config), invalid_argument);
+}
+
+TEST(MarketDataFeedHandlerShardTest, PreservesPerSymbolOrderingAcrossShards) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandlerConfig config;
+    config.shardCount = 4;
+    config.shardQueueCapacity = 64;
+
+    MarketDataFeedHandler handler(queue, config);
+    EXPECT_EQ(handler.getShardCount(), 4);
+
+    auto recorder = make_shared<ShardRecordingSubscriber>();
+    handler.subscribe(recorder);
+    handler.start();
+
+    const vector<string> symbols = {"AAPL", "GOOGL", "MSFT", "AMZN", "TSLA", "NFLX", "NVDA", "JPM"};
+    const int perSymbol = 500;
+    for (int i = 0; i < perSymbol; ++i) {
+        for (const auto& symbol : symbols) {
+            queue->push(MarketDataMessage{
+                .symbol = symbol,
+                .side = OrderSide::BUY,
+                .price = 100.0,
+                .quantity = i,
+                .timestamp = chrono::system_clock::now()
+            });
+        }
+    }
+
+    const int total = perSymbol * static_cast<int>(symbols.size());
+    auto deadline = chrono::steady_clock::now() + 10s;
+    while (recorder->received.load() < total && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(1ms);
+    }
+    handler.stop();
+
+    ASSERT_EQ(recorder->received.load(), total);
+    for (const auto& symbol : symbols) {
+        const auto& quantities = recorder->quantitiesBySymbol[symbol];
+        ASSERT_EQ(quantities.size(), perSymbol) << symbol;
+        for (int i = 0; i < perSymbol; ++i) ASSERT_EQ(quantities[i], i) << symbol;
+
+        // Every callback for a symbol runs on that symbol's shard
+        EXPECT_EQ(recorder->threadsBySymbol[symbol].size(), 1) << symbol;
+        EXPECT_EQ(handler.getStatsTracker()->getStats(symbol).tradeCount, perSymbol) << symbol;
+    }
+}
+
+TEST(MarketDataFeedHandlerShardTest, RestartsWithShards) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandlerConfig config;
+    config.shardCount = 3;
+
+    MarketDataFeedHandler handler(queue, config);
+    auto countingSubscriber = make_shared<CountingSubscriber>();
+    handler.subscribe(countingSubscriber);
+
+    for (int round = 0; round < 3; ++round) {
+        handler.start();
+        for (int i = 0; i < 20; ++i) {
+            queue->push(MarketDataMessage{
+                .symbol = "SYM" + to_string(i),
+                .side = OrderSide::SELL,
+                .price = 10.0,
+                .quantity = 1,
+                .timestamp = chrono::system_clock::now()
+            });
+        }
+
+        auto deadline = chrono::steady_clock::now() + 5s;
+        while (countingSubscriber->received.load() < 20 * (round + 1) && chrono::steady_clock::now() < deadline) {
+            this_thread::sleep_for(1ms);
+        }
+        handler.stop();
+    }
+
+    EXPECT_EQ(countingSubscriber->received.load(), 60);
+}
+
+class SlowCountingSubscriber : public IMarketDataSubscriber {
+public:
+    atomic<int> received{0};
+
+    void onMarketData(const MarketDataMessage& message) override {
+        this_thread::sleep_for(50us);
+        received++;
+    }
+};
+
+TEST(MarketDataFeedHandlerShardTest, StopDeliversEverythingRoutedToShards) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandlerConfig config;
+    config.shardCount = 4;
+    config.shardQueueCapacity = 4096;
+
+    MarketDataFeedHandler handler(queue, config);
+    auto slowSubscriber = make_shared<SlowCountingSubscriber>();
+    handler.subscribe(slowSubscriber);
+    handler.start();
+
+    const int total = 8000;
+    for (int i = 0; i < total; ++i) {
+        queue->push(MarketDataMessage{
+            .symbol = "SYM" + to_string(i % 16),
+            .side = OrderSide::BUY,
+            .price = 10.0,
+            .quantity = 1,
+            .timestamp = chrono::system_clock::now()
+        });
+    }
+
+    // Once the router has taken everything the backlog sits in the shard rings, stop must still deliver it
+    auto deadline = chrono::steady_clock::now() + 10s;
+    while (!queue->empty() && chrono::steady_clock::now() < deadline) this_thread::sleep_for(1ms);
+    ASSERT_TRUE(queue->empty());
+    EXPECT_LT(slowSubscriber->received.load(), total);
+    handler.stop();
+
+    EXPECT_EQ(slowSubscriber->received.load(), total);
+}
+
+class SelfUnsubscribingSubscriber : public IMarketDataSubscriber {
+public:
+    MarketDataFeedHandler* handler = nullptr;
+    weak_ptr<IMarketDataSubscriber> self;
+    atomic<int> received{0};
+
+    void onMarketData(const MarketDataMessage& message) override {
+        if (++received == 1) handler->unsubscribe(self.lock());
+    }
+};
+
+TEST(MarketDataFeedHandlerSubscriberListTest, SubscriberCanUnsubscribeFromCallback) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandlerConfig config;
+    config.batchDelivery = false; // a batch is delivered against one snapshot, per message delivery re-checks it
+    MarketDataFeedHandler handler(queue, config);
+
+    auto selfUnsubscriber = make_shared<SelfUnsubscribingSubscriber>();
+    selfUnsubscriber->handler = &handler;
+    selfUnsubscriber->self = selfUnsubscriber;
+    auto countingSubscriber = make_shared<CountingSubscriber>();
+    handler.subscribe(selfUnsubscriber);
+    handler.subscribe(countingSubscriber);
+    handler.start();
+
+    for (int i = 0; i < 10; ++i) {
+        queue->push(MarketDataMessage{
+            .symbol = "IBM",
+            .side = OrderSide::BUY,
+            .price = 180.0,
+            .quantity = 5,
+            .timestamp = chrono::system_clock::now()
+        });
+    }
+
+    auto deadline = chrono::steady_clock::now() + 5s;
+    while (countingSubscriber->received.load() < 10 && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(1ms);
+    }
+    handler.stop();
+
+    // The removal is visible from the very next message, even within the same batch
+    EXPECT_EQ(selfUnsubscriber->received.load(), 1);
+    EXPECT_EQ(countingSubscriber->received.load(), 10);
+}
+
+TEST(MarketDataFeedHandlerSubscriberListTest, SubscribeTakesEffectWhileRunning) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandler handler(queue);
+    auto first = make_shared<CountingSubscriber>();
+    auto second = make_shared<CountingSubscriber>();
+    handler.subscribe(first);
+    handler.start();
+
+    auto pushAndWait = [&](int expected) {
+        queue->push(MarketDataMessage{
+            .symbol = "ORCL",
+            .side = OrderSide::SELL,
+            .price = 120.0,
+            .quantity = 1,
+            .timestamp = chrono::system_clock::now()
+        });
+        auto deadline = chrono::steady_clock::now() + 5s;
+        while (first->received.load() < expected && chrono::steady_clock::now() < deadline) {
+            this_thread::sleep_for(1ms);
+        }
+    };
+
+    pushAndWait(1);
+    handler.subscribe(second);
+    pushAndWait(2);
+    handler.unsubscribe(first);
+    queue->push(MarketDataMessage{
+        .symbol = "ORCL",
+        .side = OrderSide::SELL,
+        .price = 120.0,
+        .quantity = 1,
+        .timestamp = chrono::system_clock::now()
+    });
+
+    auto deadline = chrono::steady_clock::now() + 5s;
+    while (second->received.load() < 2 && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(1ms);
+    }
+    handler.stop();
+
+    EXPECT_EQ(first->received.load(), 2);
+    EXPECT_EQ(second->received.load(), 2);
+}
+
+class SymbolRecordingSubscriber : public IMarketDataSubscriber {
+public:
+    mutex recordMutex;
+    multiset<string> symbols;
+    atomic<int> received{0};
+
+    void onMarketData(const MarketDataMessage& message) override {
+        {
+            lock_guard<mutex> lock(recordMutex);
+            symbols.insert(message.symbol);
+        }
+        received++;
+    }
+};
+
+TEST(MarketDataFeedHandlerSubscriberListTest, DeliversOnlySubscribedSymbols) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandler handler(queue);
+
+    auto techOnly = make_shared<SymbolRecordingSubscriber>();
+    auto bankOnly = make_shared<SymbolRecordingSubscriber>();
+    auto everything = make_shared<SymbolRecordingSubscriber>();
+    auto wildcard = make_shared<SymbolRecordingSubscriber>();
+    handler.subscribe(techOnly, unordered_set<string>{"AAPL", "MSFT"});
+    handler.subscribe(bankOnly, unordered_set<string>{"JPM"});
+    handler.subscribe(everything);
+    handler.subscribe(wildcard, unordered_set<string>{SubscriptionOptions::ALL_SYMBOLS});
+    handler.start();
+
+    const vector<string> symbols = {"AAPL", "MSFT", "JPM", "TSLA"};
+    for (int i = 0; i < 40; ++i) {
+        queue->push(MarketDataMessage{
+            .symbol = symbols[i % symbols.size()],
+            .side = OrderSide::BUY,
+            .price = 100.0,
+            .quantity = 1,
+            .timestamp = chrono::system_clock::now()
+        });
+    }
+
+    auto deadline = chrono::steady_clock::now() + 5s;
+    while (everything->received.load() < 40 && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(1ms);
+    }
+    handler.stop();
+
+    EXPECT_EQ(techOnly->received.load(), 20);
+    EXPECT_EQ(techOnly->symbols.count("AAPL"), 10);
+    EXPECT_EQ(techOnly->symbols.count("MSFT"), 10);
+    EXPECT_EQ(bankOnly->received.load(), 10);
+    EXPECT_EQ(bankOnly->symbols.count("JPM"), 10);
+    EXPECT_EQ(everything->received.load(), 40);
+    EXPECT_EQ(wildcard->received.load(), 40);
+    EXPECT_EQ(wildcard->symbols.count("TSLA"), 10);
+
+    // Stats still cover every symbol regardless of subscriptions
+    EXPECT_EQ(handler.getStatsTracker()->getStats("TSLA").tradeCount, 10);
+}
+
+TEST(MarketDataFeedHandlerSubscriberListTest, FilteredAsynchronousSubscription) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandler handler(queue);
+
+    auto subscriber = make_shared<SymbolRecordingSubscriber>();
+    SubscriptionOptions options = SubscriptionOptions::asynchronous(256, OverflowPolicy::BLOCK);
+    options.symbols = {"NFLX"};
+    handler.subscribe(subscriber, options);
+    handler.start();
+
+    for (int i = 0; i < 30; ++i) {
+        queue->push(MarketDataMessage{
+            .symbol = i % 3 == 0 ? "NFLX" : "META",
+            .side = OrderSide::SELL,
+            .price = 500.0,
+            .quantity = 1,
+            .timestamp = chrono::system_clock::now()
+        });
+    }
+
+    auto deadline = chrono::steady_clock::now() + 5s;
+    while (handler.getStatsTracker()->getStats("META").tradeCount < 20 && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(1ms);
+    }
+    handler.stop();
+    handler.unsubscribe(subscriber); // flushes the lane
+
+    EXPECT_EQ(subscriber->received.load(), 10);
+    EXPECT_EQ(subscriber->symbols.count("META"), 0);
+}
+
+class BatchRecordingSubscriber : public IMarketDataSubscriber {
+public:
+    atomic<int> received{0};
+    atomic<int> batches{0};
+    atomic<size_t> largestBatch{0};
+    mutex recordMutex;
+    vector<int> quantities;
+
+    void onMarketData(const MarketDataMessage& message) override {
+        {
+            lock_guard<mutex> lock(recordMutex);
+            quantities.push_back(message.quantity);
+        }
+        received++;
+    }
+
+    void onMarketDataBatch(Span<const MarketDataMessage> messages) override {
+        batches++;
+        if (messages.size() > largestBatch) largestBatch = messages.size();
+        IMarketDataSubscriber::onMarketDataBatch(messages);
+    }
+};
+
+TEST(MarketDataFeedHandlerQueueTest, DeliversBacklogAsBatches) {
+    for (bool batchDelivery : {true, false}) {
+        auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+        MarketDataFeedHandlerConfig config;
+        config.batchDelivery = batchDelivery;
+        MarketDataFeedHandler handler(queue, config);
+
+        auto wildcard = make_shared<BatchRecordingSubscriber>();
+        auto filtered = make_shared<BatchRecordingSubscriber>();
+        handler.subscribe(wildcard);
+        handler.subscribe(filtered, unordered_set<string>{"QCOM"});
+
+        // Queue a backlog before the dispatcher starts so it drains it in one go
+        for (int i = 0; i < 100; ++i) {
+            queue->push(MarketDataMessage{
+                .symbol = i % 2 == 0 ? "QCOM" : "INTC",
+                .side = OrderSide::BUY,
+                .price = 50.0,
+                .quantity = i,
+                .timestamp = chrono::system_clock::now()
+            });
+        }
+        handler.start();
+
+        auto deadline = chrono::steady_clock::now() + 5s;
+        while (wildcard->received.load() < 100 && chrono::steady_clock::now() < deadline) {
+            this_thread::sleep_for(1ms);
+        }
+        handler.stop();
+
+        ASSERT_EQ(wildcard->received.load(), 100);
+        for (int i = 0; i < 100; ++i) EXPECT_EQ(wildcard->quantities[i], i);
+        EXPECT_EQ(filtered->received.load(), 50);
+        EXPECT_EQ(filtered->batches.load(), 0); // filtered subscribers only see their own symbols, one at a time
+
+        if (batchDelivery) EXPECT_GT(wildcard->largestBatch.load(), 1);
+        else EXPECT_EQ(wildcard->batches.load(), 0);
+    }
+}
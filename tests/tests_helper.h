@@ -1,34 +1,45 @@
-#include <curl/curl.h>
-#include <iostream>
+#pragma once
+
+#include "../include/MarketDataMessage.h"
+
+#include <chrono>
+#include <functional>
+#include <optional>
 #include <regex>
 #include <cmath>
+#include <string>
+#include <thread>
 
 
-size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
-    static_cast<std::string*>(userp)->append(static_cast<char*>(contents), size * nmemb);
-    return size * nmemb;
+// Fixed base for tests that place trades at exact times, far from the real clock
+inline const std::chrono::system_clock::time_point TEST_EPOCH = std::chrono::system_clock::time_point(std::chrono::hours(24 * 365 * 50));
+
+// A BUY trade stamped now, or at TEST_EPOCH + offset when an offset is given
+inline MarketDataMessage makeMessage(const std::string& symbol, double price, int quantity, std::optional<std::chrono::milliseconds> offset = std::nullopt) {
+    return MarketDataMessage{
+        .symbol = symbol,
+        .side = OrderSide::BUY,
+        .price = price,
+        .quantity = quantity,
+        .timestamp = offset ? TEST_EPOCH + *offset : std::chrono::system_clock::now()
+    };
 }
 
-std::string httpGet(const std::string& url) {
-    CURL* curl = curl_easy_init();
-    std::string response;
-    if(curl) {
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-        CURLcode res = curl_easy_perform(curl);
-        if(res != CURLE_OK)
-            std::cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << std::endl;
-        curl_easy_cleanup(curl);
+// Polls condition every millisecond, false if it still does not hold after timeout
+inline bool waitFor(const std::function<bool()>& condition, std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
-    return response;
+    return true;
 }
 
-bool approximatelyEqual(double a, double b, double epsilon = 1e-6) {
-    return abs(a - b) < epsilon;
+inline bool approximatelyEqual(double a, double b, double epsilon = 1e-6) {
+    return std::abs(a - b) < epsilon;
 }
 
-bool fieldMatches(const std::string& response, const std::string& key, double expected) {
+inline bool fieldMatches(const std::string& response, const std::string& key, double expected) {
     std::regex pattern("\"" + key + R"(\":\s*([0-9.]+))");
     std::smatch match;
     if (std::regex_search(response, match, pattern)) {
@@ -36,4 +47,4 @@ bool fieldMatches(const std::string& response, const std::string& key, double ex
         return approximatelyEqual(actual, expected);
     }
     return false;
-}
\ No newline at end of file
+}
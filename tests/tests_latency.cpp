@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include "../include/LatencyTracker.h"
+#include "../include/MarketDataFeedHandler.h"
+#include "../include/ThreadSafeMessageQueue.h"
+
+#include "tests_helper.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+TEST(LatencyHistogramTest, EmptyHistogramReportsZero) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.percentile(0.5), 0);
+    EXPECT_EQ(histogram.max(), 0);
+    EXPECT_EQ(histogram.mean(), 0.0);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram histogram;
+    for (int i = 1; i <= 50; ++i) histogram.record(i);
+
+    EXPECT_EQ(histogram.count(), 50);
+    EXPECT_EQ(histogram.percentile(0.5), 25);
+    EXPECT_EQ(histogram.percentile(1.0), 50);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 25.5);
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinRelativeError) {
+    LatencyHistogram histogram;
+    for (int64_t i = 1; i <= 100000; ++i) histogram.record(i * 100); // 100 ns .. 10 ms
+
+    auto withinError = [](int64_t actual, double expected) {
+        return std::abs(static_cast<double>(actual) - expected) <= expected * 0.035;
+    };
+
+    EXPECT_TRUE(withinError(histogram.percentile(0.50), 5000000.0)) << histogram.percentile(0.50);
+    EXPECT_TRUE(withinError(histogram.percentile(0.99), 9900000.0)) << histogram.percentile(0.99);
+    EXPECT_TRUE(withinError(histogram.percentile(0.999), 9990000.0)) << histogram.percentile(0.999);
+    EXPECT_EQ(histogram.max(), 10000000);
+    EXPECT_LE(histogram.percentile(1.0), histogram.max());
+}
+
+TEST(LatencyHistogramTest, ClampsOutOfRangeValues) {
+    LatencyHistogram histogram;
+    histogram.record(-5);
+    histogram.record(LatencyHistogram::MAX_TRACKABLE_NS * 4);
+
+    EXPECT_EQ(histogram.count(), 2);
+    EXPECT_EQ(histogram.percentile(0.0), 0);
+    EXPECT_EQ(histogram.max(), LatencyHistogram::MAX_TRACKABLE_NS);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecordsAreAllCounted) {
+    LatencyHistogram histogram;
+    vector<thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&histogram, t] {
+            for (int i = 0; i < 25000; ++i) histogram.record(1000 + t);
+        });
+    }
+    for (auto& writer : writers) writer.join();
+
+    EXPECT_EQ(histogram.count(), 100000);
+    EXPECT_EQ(histogram.max(), 1003);
+}
+
+TEST(LatencyTrackerTest, SkipsUnstampedSpans) {
+    LatencyTracker tracker;
+    tracker.recordSpan(LatencyStage::PARSE, 0, 1000);
+    tracker.recordSpan(LatencyStage::PARSE, 400, 1000);
+
+    auto summary = tracker.getSummary(LatencyStage::PARSE);
+    EXPECT_EQ(summary.count, 1);
+    EXPECT_EQ(summary.maxNs, 600);
+    EXPECT_EQ(tracker.getSummary(LatencyStage::QUEUE).count, 0);
+
+    tracker.reset();
+    EXPECT_EQ(tracker.getSummary(LatencyStage::PARSE).count, 0);
+}
+
+TEST(LatencyTrackerTest, FeedHandlerRecordsEveryStage) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandler handler(queue);
+
+    class CountingSubscriber : public IMarketDataSubscriber {
+    public:
+        atomic<int> count{0};
+        void onMarketData(const MarketDataMessage&) override { ++count; }
+    };
+    auto first = make_shared<CountingSubscriber>();
+    auto second = make_shared<CountingSubscriber>();
+    handler.subscribe(first);
+    handler.subscribe(second, unordered_set<string>{"AAPL"});
+    handler.start();
+
+    for (int i = 0; i < 100; ++i) {
+        MarketDataMessage msg{
+            .symbol = i % 2 ? "AAPL" : "MSFT",
+            .side = OrderSide::BUY,
+            .price = 100.0,
+            .quantity = 1,
+            .timestamp = chrono::system_clock::now()
+        };
+        msg.ingressNs = latencyClockNs();
+        msg.enqueueNs = latencyClockNs();
+        queue->push(msg);
+    }
+    queue->push(MarketDataMessage{ .symbol = "AAPL", .side = OrderSide::BUY, .price = 100.0, .quantity = 1 }); // not stamped
+
+    ASSERT_TRUE(waitFor([&] { return first->count.load() == 101 && second->count.load() == 51; }));
+    handler.stop();
+
+    const auto& tracker = *handler.getLatencyTracker();
+    EXPECT_EQ(tracker.getSummary(LatencyStage::PARSE).count, 100);
+    EXPECT_EQ(tracker.getSummary(LatencyStage::QUEUE).count, 100);
+    EXPECT_EQ(tracker.getSummary(LatencyStage::DISPATCH).count, 152);    // once per subscriber callback
+    EXPECT_EQ(tracker.getSummary(LatencyStage::END_TO_END).count, 150);
+
+    auto endToEnd = tracker.getSummary(LatencyStage::END_TO_END);
+    EXPECT_LE(endToEnd.p50Ns, endToEnd.p99Ns);
+    EXPECT_LE(endToEnd.p99Ns, endToEnd.p999Ns);
+    EXPECT_LE(endToEnd.p999Ns, endToEnd.maxNs);
+}
+
+TEST(LatencyTrackerTest, TrackingCanBeDisabled) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandlerConfig config;
+    config.latencyTracking = false;
+    MarketDataFeedHandler handler(queue, config);
+    handler.start();
+
+    MarketDataMessage msg{ .symbol = "AAPL", .side = OrderSide::BUY, .price = 100.0, .quantity = 1 };
+    msg.ingressNs = latencyClockNs();
+    msg.enqueueNs = msg.ingressNs;
+    queue->push(msg);
+
+    ASSERT_TRUE(waitFor([&] { return handler.getStatsTracker()->getStats("AAPL").tradeCount == 1; }));
+    handler.stop();
+
+    for (size_t i = 0; i < LatencyTracker::STAGE_COUNT; ++i) {
+        EXPECT_EQ(handler.getLatencyTracker()->getSummary(static_cast<LatencyStage>(i)).count, 0);
+    }
+}
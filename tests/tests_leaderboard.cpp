@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "../include/Leaderboard.h"
+#include "../include/MarketDataStatsTracker.h"
+
+#include "tests_helper.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+static vector<string> symbolsOf(const vector<LeaderboardEntry>& leaders) {
+    vector<string> symbols;
+    for (const auto& entry : leaders) symbols.push_back(entry.symbol.str());
+    return symbols;
+}
+
+TEST(LeaderboardTest, KeepsTopByValue) {
+    Leaderboard board(3);
+    board.offer("LB_A", 0, 10);
+    board.offer("LB_B", 0, 30);
+    board.offer("LB_C", 0, 20);
+    board.offer("LB_D", 0, 5);   // below the weakest member of a full board
+    board.offer("LB_E", 0, 25);  // evicts LB_A
+
+    EXPECT_EQ(symbolsOf(board.top(10)), (vector<string>{ "LB_B", "LB_E", "LB_C" }));
+    EXPECT_EQ(symbolsOf(board.top(1)), (vector<string>{ "LB_B" }));
+
+    board.offer("LB_C", 20, 40); // members move without duplicating
+    auto top = board.top(10);
+    ASSERT_EQ(top.size(), 3);
+    EXPECT_EQ(top[0].symbol, "LB_C");
+    EXPECT_EQ(top[0].value, 40);
+}
+
+TEST(LeaderboardTest, MemberThatFallsCanBeReplaced) {
+    Leaderboard board(2);
+    board.offer("LB_F", 0, 10);
+    board.offer("LB_G", 0, 20);
+    board.offer("LB_F", 10, 1);  // a member dropping below the threshold still updates its entry
+    board.offer("LB_H", 0, 5);
+
+    EXPECT_EQ(symbolsOf(board.top(10)), (vector<string>{ "LB_G", "LB_H" }));
+}
+
+TEST(LeaderboardTest, ZeroCapacityIsEmpty) {
+    Leaderboard board(0);
+    board.offer("LB_I", 0, 10);
+    EXPECT_TRUE(board.top(5).empty());
+}
+
+TEST(LeaderboardTest, MatchesFullSortOfMonotoneMetric) {
+    Leaderboard board(20);
+    unordered_map<string, double> totals;
+    mt19937 rng(7);
+    uniform_int_distribution<int> pick(0, 199);
+    uniform_int_distribution<int> size(1, 500);
+
+    for (int i = 0; i < 20000; ++i) {
+        const string symbol = "LBR" + to_string(pick(rng));
+        const double previous = totals[symbol];
+        totals[symbol] += size(rng);
+        board.offer(symbol, previous, totals[symbol]);
+    }
+
+    vector<pair<double, string>> sorted;
+    for (const auto& [symbol, total] : totals) sorted.emplace_back(total, symbol);
+    sort(sorted.rbegin(), sorted.rend());
+
+    auto top = board.top(20);
+    ASSERT_EQ(top.size(), 20);
+    for (size_t i = 0; i < top.size(); ++i) EXPECT_EQ(top[i].value, sorted[i].first);
+}
+
+TEST(LeaderboardTest, TrackerServesEveryMetric) {
+    MarketDataStatsTrackerConfig config;
+    config.leaderboardSize = 5;
+    MarketDataStatsTracker tracker(config);
+
+    tracker.update(makeMessage("LDR_BIG", 10.0, 1000));     // most volume
+    tracker.update(makeMessage("LDR_BUSY", 50.0, 1));
+    tracker.update(makeMessage("LDR_BUSY", 50.0, 1));
+    tracker.update(makeMessage("LDR_BUSY", 50.0, 1));      // most trades
+    tracker.update(makeMessage("LDR_RICH", 5000.0, 10));    // most notional
+    tracker.update(makeMessage("LDR_DROP", 100.0, 1));
+    tracker.update(makeMessage("LDR_DROP", 80.0, 1));      // biggest move, down 20%
+    tracker.update(makeMessage("LDR_UP", 100.0, 1));
+    tracker.update(makeMessage("LDR_UP", 105.0, 1));
+
+    EXPECT_EQ(tracker.getLeaders(LeaderboardMetric::VOLUME, 1)[0].symbol, "LDR_BIG");
+    EXPECT_EQ(tracker.getLeaders(LeaderboardMetric::TRADE_COUNT, 1)[0].symbol, "LDR_BUSY");
+    EXPECT_EQ(tracker.getLeaders(LeaderboardMetric::NOTIONAL, 1)[0].symbol, "LDR_RICH");
+    EXPECT_DOUBLE_EQ(tracker.getLeaders(LeaderboardMetric::NOTIONAL, 1)[0].value, 50000.0);
+
+    auto movers = tracker.getLeaders(LeaderboardMetric::CHANGE, 2);
+    ASSERT_EQ(movers.size(), 2);
+    EXPECT_EQ(movers[0].symbol, "LDR_DROP");
+    EXPECT_DOUBLE_EQ(movers[0].value, -20.0);
+    EXPECT_EQ(movers[1].symbol, "LDR_UP");
+    EXPECT_DOUBLE_EQ(movers[1].value, 5.0);
+
+    EXPECT_EQ(tracker.getLeaders(LeaderboardMetric::VOLUME, 100).size(), 5);
+}
+
+TEST(LeaderboardTest, ShrinkingMoveLosesItsPlace) {
+    MarketDataStatsTrackerConfig config;
+    config.leaderboardSize = 1;
+    MarketDataStatsTracker tracker(config);
+
+    tracker.update(makeMessage("LDS_BACK", 100.0, 1));
+    tracker.update(makeMessage("LDS_BACK", 110.0, 1));    // leads at +10%
+    tracker.update(makeMessage("LDS_REAL", 100.0, 1));
+    tracker.update(makeMessage("LDS_REAL", 92.0, 1));     // -8%, smaller than the leader's move at the time
+    ASSERT_EQ(tracker.getLeaders(LeaderboardMetric::CHANGE, 1)[0].symbol, "LDS_BACK");
+
+    tracker.update(makeMessage("LDS_BACK", 100.0, 1));    // back to 0%, the illiquid name never trades again
+    auto movers = tracker.getLeaders(LeaderboardMetric::CHANGE, 5);
+    ASSERT_EQ(movers.size(), 1);
+    EXPECT_EQ(movers[0].symbol, "LDS_REAL");
+    EXPECT_DOUBLE_EQ(movers[0].value, -8.0);
+}
+
+TEST(LeaderboardTest, MoversAreOrderedByTheValuesReported) {
+    MarketDataStatsTracker tracker;
+    for (int i = 0; i < 40; ++i) {
+        const string symbol = "LDO" + to_string(i);
+        tracker.update(makeMessage(symbol, 100.0, 1));
+        tracker.update(makeMessage(symbol, 100.0 + (i % 2 ? -1 : 1) * (i * 7 % 23), 1));
+    }
+
+    auto movers = tracker.getLeaders(LeaderboardMetric::CHANGE, 10);
+    ASSERT_EQ(movers.size(), 10);
+    for (size_t i = 1; i < movers.size(); ++i) EXPECT_GE(abs(movers[i - 1].value), abs(movers[i].value));
+    for (const auto& mover : movers) EXPECT_DOUBLE_EQ(mover.value, tracker.getStats(mover.symbol).getChangePercent());
+}
+
+TEST(LeaderboardTest, MetricNamesRoundTrip) {
+    for (auto metric : { LeaderboardMetric::VOLUME, LeaderboardMetric::TRADE_COUNT, LeaderboardMetric::NOTIONAL, LeaderboardMetric::CHANGE }) {
+        EXPECT_EQ(leaderboardMetricFromString(to_string(metric)), metric);
+    }
+    EXPECT_FALSE(leaderboardMetricFromString("bogus").has_value());
+}
+
+TEST(LeaderboardTest, ConcurrentWritersAgreeWithFinalTotals) {
+    MarketDataStatsTrackerConfig config;
+    config.leaderboardSize = 10;
+    MarketDataStatsTracker tracker(config);
+
+    // Two writers own disjoint symbols, like two dispatcher shards
+    auto writer = [&](const string& prefix) {
+        for (int i = 0; i < 20000; ++i) tracker.update(makeMessage(prefix + to_string(i % 50), 10.0, 1 + i % 50));
+    };
+    thread first(writer, "LCA");
+    thread second(writer, "LCB");
+    atomic<bool> reading{true};
+    thread reader([&] { while (reading) tracker.getLeaders(LeaderboardMetric::VOLUME, 10); });
+    first.join();
+    second.join();
+    reading = false;
+    reader.join();
+
+    auto leaders = tracker.getLeaders(LeaderboardMetric::VOLUME, 10);
+    ASSERT_EQ(leaders.size(), 10);
+    for (size_t i = 0; i < leaders.size(); ++i) {
+        EXPECT_DOUBLE_EQ(leaders[i].value, static_cast<double>(tracker.getStats(leaders[i].symbol.id()).totalVolume));
+        EXPECT_EQ(leaders[i].value, 400 * (50 - i / 2)); // symbol k of each writer trades k + 1 shares 400 times
+    }
+}
@@ -3,7 +3,7 @@
 #include "../include/rest/MarketDataRestHandler.h"
 #include "../include/MarketDataMessage.h"
 
-#include "tests_helper.h"
+#include "tests_http_helper.h"
 
 #include <curl/curl.h>
 #include <chrono>
@@ -20,11 +20,13 @@ using namespace std;
 class MarketDataRestHandlerTest : public ::testing::Test {
 protected:
     shared_ptr<MarketDataStatsTracker> statsTracker;
+    shared_ptr<LatencyTracker> latencyTracker;
     unique_ptr<MarketDataRestApi> restApi;
 
     void SetUp() override {
         statsTracker = make_shared<MarketDataStatsTracker>();
-        restApi = make_unique<MarketDataRestApi>(statsTracker);
+        latencyTracker = make_shared<LatencyTracker>();
+        restApi = make_unique<MarketDataRestApi>(statsTracker, latencyTracker);
         restApi->start(18080); // Start the REST API on port 18080
         this_thread::sleep_for(std::chrono::milliseconds(500));
     }
@@ -33,6 +35,7 @@ protected:
         if (restApi) restApi->stop();
         restApi.reset();
         statsTracker.reset();
+        latencyTracker.reset();
     }
 };
 
@@ -118,4 +121,99 @@ TEST_F(MarketDataRestHandlerTest, HandlesUpdatedSymbol) {
     EXPECT_TRUE(fieldMatches(response2, "lastPrice", 2850.0));
     EXPECT_TRUE(fieldMatches(response2, "lowPrice", 2800.0));
     EXPECT_TRUE(fieldMatches(response2, "highPrice", 2850.0));
-}
\ No newline at end of file
+}
+
+TEST_F(MarketDataRestHandlerTest, GetLatencySummary) {
+    // Same samples in every stage, the response key order is not guaranteed
+    for (size_t i = 0; i < LatencyTracker::STAGE_COUNT; ++i) {
+        for (int j = 0; j < 1000; ++j) latencyTracker->record(static_cast<LatencyStage>(i), 500);
+    }
+
+    string response = httpGet("http://localhost:18080/latency");
+
+    EXPECT_NE(response.find("\"end_to_end\""), string::npos);
+    EXPECT_TRUE(fieldMatches(response, "count", 1000));
+    EXPECT_TRUE(fieldMatches(response, "maxNs", 500));
+    EXPECT_TRUE(fieldMatches(response, "p99Ns", 500));
+}
+
+TEST_F(MarketDataRestHandlerTest, GetMetricsInPrometheusFormat) {
+    MetricsRegistry::instance().counter("dmhandler_rest_test_total", "Counter registered by the REST test").increment(7);
+    latencyTracker->record(LatencyStage::QUEUE, 2000);
+
+    string response = httpGet("http://localhost:18080/metrics");
+
+    EXPECT_NE(response.find("# TYPE dmhandler_rest_test_total counter"), string::npos);
+    EXPECT_NE(response.find("dmhandler_rest_test_total 7"), string::npos);
+    EXPECT_NE(response.find("dmhandler_latency_seconds_count{stage=\"queue\"} 1"), string::npos);
+}
+
+TEST_F(MarketDataRestHandlerTest, GetAllStatsFromSnapshot) {
+    statsTracker->update(MarketDataMessage{ .symbol = "NFLX", .side = OrderSide::BUY, .price = 600.0, .quantity = 10 });
+    statsTracker->update(MarketDataMessage{ .symbol = "AMZN", .side = OrderSide::SELL, .price = 180.0, .quantity = 20 });
+
+    string response = httpGet("http://localhost:18080/stats");
+
+    EXPECT_NE(response.find("\"NFLX\""), string::npos);
+    EXPECT_NE(response.find("\"AMZN\""), string::npos);
+    EXPECT_NE(response.find("\"consistent\":true"), string::npos);
+}
+
+TEST_F(MarketDataRestHandlerTest, GetRollingWindowStats) {
+    statsTracker->update(MarketDataMessage{ .symbol = "TSLA", .side = OrderSide::BUY, .price = 200.0, .quantity = 10, .timestamp = chrono::system_clock::now() });
+    statsTracker->update(MarketDataMessage{ .symbol = "TSLA", .side = OrderSide::BUY, .price = 210.0, .quantity = 30, .timestamp = chrono::system_clock::now() });
+
+    string response = httpGet("http://localhost:18080/stats/TSLA?window=1m");
+    EXPECT_TRUE(fieldMatches(response, "vwap", 207.5));
+    EXPECT_TRUE(fieldMatches(response, "totalVolume", 40));
+    EXPECT_TRUE(fieldMatches(response, "tradeCount", 2));
+
+    string unknown = httpGet("http://localhost:18080/stats/TSLA?window=3d");
+    EXPECT_NE(unknown.find("Unknown window"), string::npos);
+}
+
+TEST_F(MarketDataRestHandlerTest, GetSymbolStatsIncludesQuantiles) {
+    for (int i = 1; i <= 100; ++i) {
+        statsTracker->update(MarketDataMessage{ .symbol = "NFLX", .side = OrderSide::SELL, .price = 400.0, .quantity = i, .timestamp = chrono::system_clock::now() });
+    }
+
+    string response = httpGet("http://localhost:18080/stats/NFLX");
+    EXPECT_NE(response.find("priceQuantiles"), string::npos);
+    EXPECT_NE(response.find("quantityQuantiles"), string::npos);
+    EXPECT_TRUE(fieldMatches(response, "p50", 400.0));
+}
+
+TEST_F(MarketDataRestHandlerTest, GetSymbolStatsIncludesAnalytics) {
+    const auto start = chrono::system_clock::now();
+    statsTracker->update(MarketDataMessage{ .symbol = "ORCL", .side = OrderSide::BUY, .price = 100.0, .quantity = 1, .timestamp = start });
+    statsTracker->update(MarketDataMessage{ .symbol = "ORCL", .side = OrderSide::BUY, .price = 102.0, .quantity = 1, .timestamp = start + chrono::seconds(1) });
+
+    string response = httpGet("http://localhost:18080/stats/ORCL");
+    EXPECT_TRUE(fieldMatches(response, "priceStdDev", sqrt(2.0)));
+    EXPECT_TRUE(fieldMatches(response, "realizedVolatility", log(1.02)));
+    EXPECT_TRUE(fieldMatches(response, "1s", 101.0));
+    EXPECT_NE(response.find("tradeRate"), string::npos);
+}
+
+TEST_F(MarketDataRestHandlerTest, GetLeaders) {
+    statsTracker->update(MarketDataMessage{ .symbol = "AMZN", .side = OrderSide::BUY, .price = 180.0, .quantity = 5000, .timestamp = chrono::system_clock::now() });
+
+    string response = httpGet("http://localhost:18080/leaders?by=volume&n=1");
+    EXPECT_NE(response.find("AMZN"), string::npos);
+    EXPECT_TRUE(fieldMatches(response, "value", 5000));
+
+    EXPECT_NE(httpGet("http://localhost:18080/leaders?by=bogus").find("Unknown leaderboard"), string::npos);
+    EXPECT_NE(httpGet("http://localhost:18080/leaders?n=abc").find("Invalid n"), string::npos);
+}
+
+TEST_F(MarketDataRestHandlerTest, GetSymbolStatsIncludesSides) {
+    const auto now = chrono::system_clock::now();
+    statsTracker->update(MarketDataMessage{ .symbol = "INTC", .side = OrderSide::BUY, .price = 30.0, .quantity = 300, .timestamp = now });
+    statsTracker->update(MarketDataMessage{ .symbol = "INTC", .side = OrderSide::SELL, .price = 30.0, .quantity = 100, .timestamp = now });
+
+    string response = httpGet("http://localhost:18080/stats/INTC");
+    EXPECT_TRUE(fieldMatches(response, "buyVolume", 300));
+    EXPECT_TRUE(fieldMatches(response, "sellVolume", 100));
+    EXPECT_TRUE(fieldMatches(response, "buyNotional", 9000.0));
+    EXPECT_TRUE(fieldMatches(response, "orderFlowImbalance", 0.5));
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include "../include/MetricsRegistry.h"
+#include "../include/MarketDataFeedHandler.h"
+#include "../include/ThreadSafeMessageQueue.h"
+#include "../include/parser/FileMarketDataParser.h"
+
+#include "tests_helper.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// The registry is process wide, so tests use their own metric names or compare before/after values
+
+TEST(MetricsRegistryTest, ReturnsTheSameSeriesForTheSameLabels) {
+    auto& registry = MetricsRegistry::instance();
+    Counter& first = registry.counter("test_same_series_total", "help", {{"k", "v"}});
+    Counter& again = registry.counter("test_same_series_total", "help", {{"k", "v"}});
+    Counter& other = registry.counter("test_same_series_total", "help", {{"k", "w"}});
+
+    EXPECT_EQ(&first, &again);
+    EXPECT_NE(&first, &other);
+}
+
+TEST(MetricsRegistryTest, RendersPrometheusText) {
+    auto& registry = MetricsRegistry::instance();
+    registry.counter("test_render_total", "Things counted", {{"source", "a"}}).increment(3);
+    registry.gauge("test_render_depth", "Current depth").set(-2);
+    registry.counter("test_render_seconds_total", "Time spent", {}, 1e-9).increment(1500000000);
+
+    const string text = registry.renderPrometheus();
+    EXPECT_NE(text.find("# HELP test_render_total Things counted\n# TYPE test_render_total counter\n"), string::npos);
+    EXPECT_NE(text.find("test_render_total{source=\"a\"} 3\n"), string::npos);
+    EXPECT_NE(text.find("# TYPE test_render_depth gauge\ntest_render_depth -2\n"), string::npos);
+    EXPECT_NE(text.find("test_render_seconds_total 1.5\n"), string::npos);
+}
+
+TEST(MetricsRegistryTest, EscapesLabelValues) {
+    auto& registry = MetricsRegistry::instance();
+    registry.counter("test_escape_total", "help", {{"path", "a\"b\\c\nd"}}).increment();
+
+    EXPECT_NE(registry.renderPrometheus().find("test_escape_total{path=\"a\\\"b\\\\c\\nd\"} 1\n"), string::npos);
+}
+
+TEST(MetricsRegistryTest, RejectsTypeMismatch) {
+    auto& registry = MetricsRegistry::instance();
+    registry.counter("test_type_clash", "help");
+    EXPECT_THROW(registry.gauge("test_type_clash", "help"), invalid_argument);
+}
+
+TEST(MetricsRegistryTest, RemovedSeriesLeaveTheRendering) {
+    auto& registry = MetricsRegistry::instance();
+    auto kept = registry.sharedCounter("test_removal_total", "Removal test", {{"id", "kept"}});
+    auto removed = registry.sharedCounter("test_removal_total", "Removal test", {{"id", "removed"}});
+
+    registry.remove("test_removal_total", {{"id", "removed"}});
+    removed->increment(); // still safe to touch through the shared pointer
+
+    string text = registry.renderPrometheus();
+    EXPECT_NE(text.find("test_removal_total{id=\"kept\"}"), string::npos);
+    EXPECT_EQ(text.find("test_removal_total{id=\"removed\"}"), string::npos);
+
+    registry.remove("test_removal_total", {{"id", "kept"}});
+    EXPECT_EQ(registry.renderPrometheus().find("test_removal_total"), string::npos);
+}
+
+TEST(MetricsRegistryTest, SeriesStaysUntilEveryHolderRemovesIt) {
+    auto& registry = MetricsRegistry::instance();
+    auto first = registry.sharedCounter("test_holders_total", "Holder test", {{"id", "shared"}});
+    auto second = registry.sharedCounter("test_holders_total", "Holder test", {{"id", "shared"}});
+    EXPECT_EQ(first, second);
+
+    registry.remove("test_holders_total", {{"id", "shared"}});
+    EXPECT_NE(registry.renderPrometheus().find("test_holders_total{id=\"shared\"}"), string::npos);
+
+    registry.remove("test_holders_total", {{"id", "shared"}});
+    EXPECT_EQ(registry.renderPrometheus().find("test_holders_total"), string::npos);
+}
+
+TEST(MetricsRegistryTest, GaugeTracksHighWatermark) {
+    Gauge& gauge = MetricsRegistry::instance().gauge("test_watermark", "help");
+    gauge.setMax(5);
+    gauge.setMax(3);
+    EXPECT_EQ(gauge.value(), 5);
+    gauge.setMax(9);
+    EXPECT_EQ(gauge.value(), 9);
+}
+
+TEST(MetricsRegistryTest, ConcurrentIncrementsAreAllCounted) {
+    Counter& counter = MetricsRegistry::instance().counter("test_concurrent_total", "help");
+    vector<thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&counter] {
+            for (int i = 0; i < 10000; ++i) counter.increment();
+        });
+    }
+    for (auto& writer : writers) writer.join();
+
+    EXPECT_EQ(counter.value(), 40000);
+}
+
+TEST(MetricsRegistryTest, CountsParseFailures) {
+    Counter& failures = MetricsRegistry::instance().counter(
+        "dmhandler_parse_failures_total", "Input rejected by a market data parser", {{"parser", "file"}});
+    const uint64_t before = failures.value();
+
+    FileMarketDataParser parser;
+    EXPECT_FALSE(parser.parse(string("AAPL,BUY,not_a_price,1,1")).has_value());
+    EXPECT_TRUE(parser.parse(string("AAPL,BUY,1.5,1,1")).has_value());
+
+    EXPECT_EQ(failures.value(), before + 1);
+}
+
+TEST(MetricsRegistryTest, FeedHandlerCountsDispatchAndSubscriberCallbacks) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandler handler(queue);
+
+    class CountingSubscriber : public IMarketDataSubscriber {
+    public:
+        atomic<int> count{0};
+        void onMarketData(const MarketDataMessage&) override { ++count; }
+    };
+    auto subscriber = make_shared<CountingSubscriber>();
+    SubscriptionOptions options;
+    options.name = "metrics-test";
+    handler.subscribe(subscriber, options);
+
+    auto& registry = MetricsRegistry::instance();
+    Counter& dispatched = registry.counter("dmhandler_messages_dispatched_total", "Messages delivered to subscribers by the feed handler");
+    Counter& callbacks = registry.counter("dmhandler_subscriber_callbacks_total", "Callbacks made to a subscriber", {{"subscriber", "metrics-test"}});
+    const uint64_t dispatchedBefore = dispatched.value();
+
+    handler.start();
+    for (int i = 0; i < 50; ++i) {
+        queue->push(MarketDataMessage{ .symbol = "AAPL", .side = OrderSide::BUY, .price = 100.0, .quantity = 1 });
+    }
+    ASSERT_TRUE(waitFor([&] { return subscriber->count.load() == 50; }));
+    handler.stop();
+
+    EXPECT_EQ(dispatched.value(), dispatchedBefore + 50);
+    EXPECT_GE(callbacks.value(), 1);   // batched backlogs arrive in fewer calls
+    EXPECT_LE(callbacks.value(), 50);
+
+    const string text = registry.renderPrometheus();
+    EXPECT_NE(text.find("dmhandler_subscriber_callback_seconds_total{subscriber=\"metrics-test\"}"), string::npos);
+    EXPECT_NE(text.find("dmhandler_queue_depth_high_watermark"), string::npos);
+}
+
+TEST(MetricsRegistryTest, UnsubscribeReleasesSubscriberSeries) {
+    class NullSubscriber : public IMarketDataSubscriber {
+    public:
+        void onMarketData(const MarketDataMessage&) override {}
+    };
+
+    auto& registry = MetricsRegistry::instance();
+    auto countSeries = [&registry] {
+        const string text = registry.renderPrometheus();
+        size_t count = 0;
+        for (size_t pos = text.find("dmhandler_subscriber_callbacks_total{"); pos != string::npos;
+             pos = text.find("dmhandler_subscriber_callbacks_total{", pos + 1)) ++count;
+        return count;
+    };
+    const size_t before = countSeries();
+
+    // Unnamed subscribers of two handlers are numbered process wide, so their series never collide
+    MarketDataFeedHandler first(make_shared<ThreadSafeMessageQueue<MarketDataMessage>>());
+    MarketDataFeedHandler second(make_shared<ThreadSafeMessageQueue<MarketDataMessage>>());
+    auto a = make_shared<NullSubscriber>();
+    auto b = make_shared<NullSubscriber>();
+    first.subscribe(a);
+    second.subscribe(b);
+    EXPECT_EQ(countSeries(), before + 2);
+
+    for (int i = 0; i < 100; ++i) {
+        auto churn = make_shared<NullSubscriber>();
+        first.subscribe(churn);
+        first.unsubscribe(churn);
+    }
+    EXPECT_EQ(countSeries(), before + 2);
+
+    first.unsubscribe(a);
+    second.unsubscribe(b);
+    EXPECT_EQ(countSeries(), before);
+}
+
+TEST(MetricsRegistryTest, SharedSubscriberNameKeepsItsSeriesUntilTheLastUnsubscribe) {
+    class NullSubscriber : public IMarketDataSubscriber {
+    public:
+        void onMarketData(const MarketDataMessage&) override {}
+    };
+
+    auto& registry = MetricsRegistry::instance();
+    const string series = "dmhandler_subscriber_callbacks_total{subscriber=\"shared-name\"}";
+
+    MarketDataFeedHandler first(make_shared<ThreadSafeMessageQueue<MarketDataMessage>>());
+    MarketDataFeedHandler second(make_shared<ThreadSafeMessageQueue<MarketDataMessage>>());
+    SubscriptionOptions options;
+    options.name = "shared-name";
+    auto a = make_shared<NullSubscriber>();
+    auto b = make_shared<NullSubscriber>();
+    first.subscribe(a, options);
+    second.subscribe(b, options);
+
+    first.unsubscribe(a);
+    EXPECT_NE(registry.renderPrometheus().find(series), string::npos);
+
+    second.unsubscribe(b);
+    EXPECT_EQ(registry.renderPrometheus().find(series), string::npos);
+}
@@ -132,3 +132,16 @@ TEST_F(FileMarketDataParserTest, HandlesWhitespaceForField) {
     ASSERT_FALSE(message.has_value());
 }
 
+
+TEST_F(FileMarketDataParserTest, ParsesPriceWithoutRounding) {
+    string line = "BRK.A,BUY,612345.123456,1,1633072800000000000";
+    auto message = parser.parse(line);
+
+    ASSERT_TRUE(message.has_value());
+    EXPECT_EQ(message->price.raw(), 612345123456);
+}
+
+TEST_F(FileMarketDataParserTest, HandlesTrailingGarbageInNumbers) {
+    EXPECT_FALSE(parser.parse("AAPL,BUY,150.0abc,100,1633072800000000000").has_value());
+    EXPECT_FALSE(parser.parse("AAPL,BUY,150.0,100x,1633072800000000000").has_value());
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "../include/Price.h"
+#include "../include/SymbolStats.h"
+
+#include <limits>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+TEST(PriceTest, ConvertsFromAndToDouble) {
+    Price price = 150.25;
+    EXPECT_EQ(price.raw(), 150250000);
+    EXPECT_DOUBLE_EQ(price, 150.25);
+    EXPECT_DOUBLE_EQ(price.toDouble(), 150.25);
+
+    Price tiny = 0.0000004;
+    EXPECT_EQ(tiny.raw(), 0);
+    Price rounded = 0.0000005;
+    EXPECT_EQ(rounded.raw(), 1);
+}
+
+TEST(PriceTest, SentinelsRoundTrip) {
+    EXPECT_EQ(Price(numeric_limits<double>::lowest()), Price::min());
+    EXPECT_EQ(Price(numeric_limits<double>::max()), Price::max());
+    EXPECT_EQ(Price::min().toDouble(), numeric_limits<double>::lowest());
+    EXPECT_EQ(Price::max().toDouble(), numeric_limits<double>::max());
+}
+
+TEST(PriceTest, ComparesWithPricesAndDoubles) {
+    Price low = 99.5;
+    Price high = 100.0;
+
+    EXPECT_LT(low, high);
+    EXPECT_GT(high, low);
+    EXPECT_EQ(high, 100.0);
+    EXPECT_NE(low, 100.0);
+    EXPECT_LE(low, 99.5);
+    EXPECT_GE(100.5, high);
+    EXPECT_EQ(std::max(low, high), high);
+}
+
+TEST(PriceTest, ParsesDecimalsExactly) {
+    EXPECT_EQ(Price::parse("150")->raw(), 150000000);
+    EXPECT_EQ(Price::parse("150.0")->raw(), 150000000);
+    EXPECT_EQ(Price::parse("0.1")->raw(), 100000);
+    EXPECT_EQ(Price::parse("2800.123456")->raw(), 2800123456);
+    EXPECT_EQ(Price::parse("-0.25")->raw(), -250000);
+    EXPECT_EQ(Price::parse("+7.")->raw(), 7000000);
+    EXPECT_EQ(Price::parse(".5")->raw(), 500000);
+
+    // Digits past the sixth decimal round half away from zero
+    EXPECT_EQ(Price::parse("1.0000004")->raw(), 1000000);
+    EXPECT_EQ(Price::parse("1.0000005")->raw(), 1000001);
+    EXPECT_EQ(Price::parse("-1.0000005")->raw(), -1000001);
+}
+
+TEST(PriceTest, RejectsMalformedInput) {
+    EXPECT_FALSE(Price::parse("").has_value());
+    EXPECT_FALSE(Price::parse(".").has_value());
+    EXPECT_FALSE(Price::parse("-").has_value());
+    EXPECT_FALSE(Price::parse("abc").has_value());
+    EXPECT_FALSE(Price::parse("1.2.3").has_value());
+    EXPECT_FALSE(Price::parse("12a").has_value());
+    EXPECT_FALSE(Price::parse("1e5").has_value());
+    EXPECT_FALSE(Price::parse("99999999999999999999").has_value());
+}
+
+TEST(PriceTest, StreamsAsDecimal) {
+    ostringstream os;
+    os << Price::parse("151.5").value();
+    EXPECT_EQ(os.str(), "151.5");
+}
+
+TEST(PriceTest, NotionalHasNoRoundingDrift) {
+    SymbolStats stats;
+    MarketDataMessage msg{
+        .symbol = "PENNY",
+        .side = OrderSide::BUY,
+        .price = Price::parse("0.1").value(),
+        .quantity = 1,
+        .timestamp = chrono::system_clock::now()
+    };
+
+    // 0.1 is not representable in binary, a double sum drifts after a few million additions
+    for (int i = 0; i < 10000000; ++i) stats.update(msg);
+
+    EXPECT_EQ(stats.totalNotional, static_cast<NotionalAccumulator>(1000000) * Price::SCALE);
+    EXPECT_EQ(stats.getTotalNotional(), 1000000.0);
+    EXPECT_EQ(stats.getAveragePrice(), 0.1);
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include "../include/QuantileSketch.h"
+#include "../include/MarketDataStatsTracker.h"
+
+#include "tests_helper.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static double exactQuantile(vector<double> values, double q) {
+    sort(values.begin(), values.end());
+    return values[static_cast<size_t>(q * (values.size() - 1))];
+}
+
+TEST(QuantileSketchTest, EmptySketch) {
+    QuantileSketch sketch;
+    EXPECT_EQ(sketch.count(), 0);
+    EXPECT_EQ(sketch.quantile(0.5), 0.0);
+    EXPECT_EQ(sketch.min(), 0.0);
+    EXPECT_EQ(sketch.max(), 0.0);
+}
+
+TEST(QuantileSketchTest, QuantilesWithinRelativeAccuracy) {
+    QuantileSketch sketch({ 0.001, 1024 });
+    mt19937 rng(42);
+    lognormal_distribution<double> distribution(log(150.0), 0.2);
+
+    vector<double> values;
+    for (int i = 0; i < 100000; ++i) {
+        values.push_back(distribution(rng));
+        sketch.add(values.back());
+    }
+
+    EXPECT_EQ(sketch.count(), 100000);
+    for (double q : { 0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99 }) {
+        const double exact = exactQuantile(values, q);
+        EXPECT_NEAR(sketch.quantile(q), exact, exact * 0.0021) << "q=" << q;
+    }
+    EXPECT_EQ(sketch.quantile(0.0), *min_element(values.begin(), values.end()));
+    EXPECT_EQ(sketch.quantile(1.0), *max_element(values.begin(), values.end()));
+}
+
+TEST(QuantileSketchTest, WindowFollowsDrift) {
+    // Prices drift through ~10x, more than the bucket window, so the bottom collapses but the top stays exact
+    QuantileSketch sketch({ 0.01, 64 });
+    vector<double> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(10.0 + i * 0.09);
+        sketch.add(values.back());
+    }
+
+    const double p95 = exactQuantile(values, 0.95);
+    EXPECT_NEAR(sketch.quantile(0.95), p95, p95 * 0.02);
+    EXPECT_EQ(sketch.min(), 10.0);
+    EXPECT_GE(sketch.quantile(0.01), 10.0);
+}
+
+TEST(QuantileSketchTest, MergeMatchesSingleSketch) {
+    QuantileSketch whole({ 0.01, 256 });
+    QuantileSketch low({ 0.01, 256 });
+    QuantileSketch high({ 0.01, 256 });
+
+    for (int i = 1; i <= 1000; ++i) {
+        whole.add(i);
+        (i <= 500 ? low : high).add(i);
+    }
+    low.merge(high);
+
+    EXPECT_EQ(low.count(), whole.count());
+    for (double q : { 0.05, 0.5, 0.95 }) EXPECT_DOUBLE_EQ(low.quantile(q), whole.quantile(q));
+    EXPECT_EQ(low.max(), 1000.0);
+
+    QuantileSketch other({ 0.02, 256 });
+    EXPECT_THROW(low.merge(other), invalid_argument);
+}
+
+TEST(QuantileSketchTest, MergeIntoEmptySketch) {
+    QuantileSketch source({ 0.01, 256 });
+    for (int i = 1; i <= 1000; ++i) source.add(i);
+
+    QuantileSketch empty({ 0.01, 256 });
+    empty.merge(source);
+    EXPECT_EQ(empty.count(), source.count());
+    for (double q : { 0.05, 0.5, 0.95 }) EXPECT_DOUBLE_EQ(empty.quantile(q), source.quantile(q));
+
+    // A target holding only zeros has no counted buckets either
+    QuantileSketch zeros({ 0.01, 256 });
+    zeros.add(0.0, 10);
+    zeros.merge(source);
+    EXPECT_EQ(zeros.count(), 1010);
+    EXPECT_EQ(zeros.quantile(0.005), 0.0);
+    EXPECT_NEAR(zeros.quantile(0.5), source.quantile(0.5), source.quantile(0.5) * 0.02);
+    EXPECT_NEAR(zeros.quantile(0.95), source.quantile(0.95), source.quantile(0.95) * 0.02);
+}
+
+TEST(QuantileSketchTest, CountsNonPositiveValuesAsZero) {
+    QuantileSketch sketch;
+    sketch.add(0.0, 3);
+    sketch.add(5.0, 3);
+    EXPECT_EQ(sketch.count(), 6);
+    EXPECT_EQ(sketch.quantile(0.25), 0.0);
+    EXPECT_NEAR(sketch.quantile(0.99), 5.0, 0.05);
+}
+
+TEST(QuantileSketchTest, RejectsBadSpecs) {
+    EXPECT_THROW(QuantileSketch({ 0.0, 512 }), invalid_argument);
+    EXPECT_THROW(QuantileSketch({ 1.0, 512 }), invalid_argument);
+    EXPECT_THROW(QuantileSketch({ 0.01, 1 }), invalid_argument);
+
+    MarketDataStatsTrackerConfig config;
+    config.priceSketch = { 0.0, 1024 };
+    EXPECT_THROW(MarketDataStatsTracker tracker(config), invalid_argument);
+}
+
+TEST(QuantileSketchTest, TrackerKeepsPriceAndSizeQuantiles) {
+    MarketDataStatsTracker tracker;
+    for (int i = 1; i <= 100; ++i) tracker.update(makeMessage("QNT1", 100.0 + i * 0.1, i));
+
+    auto quantiles = tracker.getQuantiles("QNT1");
+    ASSERT_TRUE(quantiles.has_value());
+    EXPECT_EQ(quantiles->price.count(), 100);
+    EXPECT_NEAR(quantiles->price.quantile(0.5), 105.0, 105.0 * 0.002);
+    EXPECT_NEAR(quantiles->price.quantile(0.95), 109.5, 109.5 * 0.002);
+    EXPECT_NEAR(quantiles->quantity.quantile(0.05), 5.0, 5.0 * 0.02);
+    EXPECT_NEAR(quantiles->quantity.quantile(0.5), 50.0, 50.0 * 0.02);
+
+    EXPECT_EQ(tracker.getQuantiles("NEVER_TRADED")->price.count(), 0);
+
+    MarketDataStatsTrackerConfig disabled;
+    disabled.quantiles = false;
+    MarketDataStatsTracker plain(disabled);
+    plain.update(makeMessage("QNT1", 100.0, 1));
+    EXPECT_FALSE(plain.getQuantiles("QNT1").has_value());
+}
+
+TEST(QuantileSketchTest, ReadersSeeWholeUpdates) {
+    MarketDataStatsTracker tracker;
+    atomic<bool> writing{true};
+    atomic<int> tornReads{0};
+
+    // Each update adds one price and one size, so both sketches must always hold the same count
+    thread writer([&] {
+        for (int i = 0; i < 20000; ++i) tracker.update(makeMessage("QNT2", 50.0 + (i % 1000), 1 + i % 500));
+        writing = false;
+    });
+    thread reader([&] {
+        while (writing) {
+            auto quantiles = tracker.getQuantiles("QNT2");
+            if (quantiles->price.count() != quantiles->quantity.count()) ++tornReads;
+        }
+    });
+    writer.join();
+    reader.join();
+
+    EXPECT_EQ(tornReads.load(), 0);
+    EXPECT_EQ(tracker.getQuantiles("QNT2")->price.count(), 20000);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "../include/RollingWindowStats.h"
+#include "../include/MarketDataStatsTracker.h"
+
+#include "tests_helper.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono_literals;
+
+TEST(RollingWindowsTest, AggregatesWithinTheWindow) {
+    RollingWindows windows({ { "10s", 10s, 10 } });
+    windows.update(makeMessage("AAPL", 100.0, 10, 0ms));
+    windows.update(makeMessage("AAPL", 110.0, 30, 2500ms));
+    windows.update(makeMessage("AAPL", 90.0, 10, 9999ms));
+
+    auto stats = windows.read(0, TEST_EPOCH + 9999ms);
+    EXPECT_EQ(stats.tradeCount, 3);
+    EXPECT_EQ(stats.totalVolume, 50);
+    EXPECT_EQ(stats.highPrice, 110.0);
+    EXPECT_EQ(stats.lowPrice, 90.0);
+    EXPECT_DOUBLE_EQ(stats.getVwap(), (100.0 * 10 + 110.0 * 30 + 90.0 * 10) / 50);
+}
+
+TEST(RollingWindowsTest, OldBucketsSlideOut) {
+    RollingWindows windows({ { "10s", 10s, 10 } });
+    windows.update(makeMessage("AAPL", 100.0, 10, 0ms));
+    windows.update(makeMessage("AAPL", 200.0, 20, 5000ms));
+
+    // At t=10.5s the bucket of t=0 has left the window, the one of t=5s has not
+    auto stats = windows.read(0, TEST_EPOCH + 10500ms);
+    EXPECT_EQ(stats.tradeCount, 1);
+    EXPECT_EQ(stats.totalVolume, 20);
+    EXPECT_EQ(stats.lowPrice, 200.0);
+
+    EXPECT_EQ(windows.read(0, TEST_EPOCH + 20s).tradeCount, 0);
+    EXPECT_EQ(windows.read(0, TEST_EPOCH + 20s).getVwap(), 0.0);
+}
+
+TEST(RollingWindowsTest, ReusedBucketIsReset) {
+    RollingWindows windows({ { "1s", 1s, 10 } });
+    windows.update(makeMessage("AAPL", 100.0, 10, 0ms));
+    windows.update(makeMessage("AAPL", 50.0, 1, 1000ms)); // same ring slot, one lap later
+
+    auto stats = windows.read(0, TEST_EPOCH + 1000ms);
+    EXPECT_EQ(stats.tradeCount, 1);
+    EXPECT_EQ(stats.highPrice, 50.0);
+
+    // A straggler from the overwritten lap is too old for the window and is ignored
+    windows.update(makeMessage("AAPL", 999.0, 100, 50ms));
+    EXPECT_EQ(windows.read(0, TEST_EPOCH + 1000ms).tradeCount, 1);
+}
+
+TEST(RollingWindowsTest, RejectsBadSpecs) {
+    EXPECT_THROW(RollingWindows({ { "zero", 1s, 0 } }), invalid_argument);
+    EXPECT_THROW(RollingWindows({ { "tiny", 0ms, 10 } }), invalid_argument);
+
+    MarketDataStatsTrackerConfig duplicate;
+    duplicate.windows = { { "1m", 60s, 60 }, { "1m", 60s, 6 } };
+    EXPECT_THROW(MarketDataStatsTracker tracker(duplicate), invalid_argument);
+}
+
+TEST(RollingWindowsTest, TrackerExposesConfiguredWindows) {
+    MarketDataStatsTracker tracker;
+    EXPECT_EQ(tracker.getWindowNames(), (vector<string>{"1s", "1m", "5m", "1h"}));
+
+    tracker.update(makeMessage("WINA", 100.0, 10, 0ms));
+    tracker.update(makeMessage("WINA", 102.0, 10, 31s));
+    tracker.update(makeMessage("WINA", 104.0, 10, 90s));
+
+    auto oneMinute = tracker.getWindowStats("WINA", "1m", TEST_EPOCH + 90s);
+    ASSERT_TRUE(oneMinute.has_value());
+    EXPECT_EQ(oneMinute->tradeCount, 2);
+    EXPECT_DOUBLE_EQ(oneMinute->getVwap(), 103.0);
+
+    auto fiveMinutes = tracker.getWindowStats("WINA", "5m", TEST_EPOCH + 90s);
+    EXPECT_EQ(fiveMinutes->tradeCount, 3);
+    EXPECT_DOUBLE_EQ(fiveMinutes->getVwap(), 102.0);
+
+    // Lifetime stats are unaffected
+    EXPECT_EQ(tracker.getStats("WINA").tradeCount, 3);
+
+    EXPECT_FALSE(tracker.getWindowStats("WINA", "2m", TEST_EPOCH).has_value());
+    EXPECT_EQ(tracker.getWindowStats("NEVER_SEEN", "1m", TEST_EPOCH)->tradeCount, 0);
+}
+
+TEST(RollingWindowsTest, TrackerWithoutWindows) {
+    MarketDataStatsTrackerConfig config;
+    config.windows.clear();
+    MarketDataStatsTracker tracker(config);
+
+    tracker.update(makeMessage("WINB", 100.0, 10, 0ms));
+    EXPECT_EQ(tracker.getStats("WINB").tradeCount, 1);
+    EXPECT_FALSE(tracker.getWindowStats("WINB", "1m", TEST_EPOCH).has_value());
+}
+
+TEST(RollingWindowsTest, ReadersSeeWholeUpdates) {
+    MarketDataStatsTrackerConfig config;
+    config.windows = { { "1h", 3600s, 60 } };
+    MarketDataStatsTracker tracker(config);
+    atomic<bool> writing{true};
+    atomic<int> tornReads{0};
+
+    // quantity 1 at price 1: volume, trade count and notional must always agree
+    thread writer([&] {
+        for (int i = 0; i < 20000; ++i) tracker.update(makeMessage("WINC", 1.0, 1, chrono::milliseconds(i)));
+        writing = false;
+    });
+    thread reader([&] {
+        while (writing) {
+            auto stats = tracker.getWindowStats("WINC", "1h", TEST_EPOCH + 30s);
+            if (stats->totalVolume != stats->tradeCount || stats->totalNotional != static_cast<NotionalAccumulator>(stats->tradeCount) * Price::SCALE) ++tornReads;
+        }
+    });
+    writer.join();
+    reader.join();
+
+    EXPECT_EQ(tornReads.load(), 0);
+    EXPECT_EQ(tracker.getWindowStats("WINC", "1h", TEST_EPOCH + 30s)->tradeCount, 20000);
+}
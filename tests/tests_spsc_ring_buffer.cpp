@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include "../include/SpscRingBuffer.h"
+#include "../include/MarketDataMessage.h"
+
+#include <thread>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+TEST(SpscRingBufferTest, DefaultConstructor) {
+    SpscRingBuffer<int> queue;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.size(), 0);
+    EXPECT_EQ(queue.capacity(), 1024);
+}
+
+TEST(SpscRingBufferTest, RoundsCapacityUpToPowerOfTwo) {
+    SpscRingBuffer<int> queue(100);
+    EXPECT_EQ(queue.capacity(), 128);
+
+    SpscRingBuffer<int> exact(64);
+    EXPECT_EQ(exact.capacity(), 64);
+}
+
+TEST(SpscRingBufferTest, ZeroCapacityThrows) {
+    EXPECT_THROW(SpscRingBuffer<int> queue(0), invalid_argument);
+}
+
+TEST(SpscRingBufferTest, PushAndPopInOrder) {
+    SpscRingBuffer<int> queue(8);
+    queue.push(1);
+    queue.push(2);
+
+    int testlVal = 3;
+    queue.push(testlVal);
+
+    int testrVal = 4;
+    queue.push(std::move(testrVal));
+
+    EXPECT_EQ(queue.size(), 4);
+    EXPECT_FALSE(queue.empty());
+
+    int value = 0;
+    for (int expected = 1; expected <= 4; ++expected) {
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, expected);
+    }
+
+    EXPECT_FALSE(queue.tryPop(value));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscRingBufferTest, TryPushFailsWhenFull) {
+    SpscRingBuffer<int> queue(4);
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(queue.tryPush(i));
+    EXPECT_FALSE(queue.tryPush(4));
+    EXPECT_EQ(queue.size(), 4);
+
+    int value = 0;
+    ASSERT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(queue.tryPush(4));
+}
+
+TEST(SpscRingBufferTest, WrapsAroundManyTimes) {
+    SpscRingBuffer<int> queue(4);
+    int value = 0;
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(queue.tryPush(i));
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscRingBufferTest, WorksThroughMessageQueueInterface) {
+    auto ring = make_shared<SpscRingBuffer<MarketDataMessage>>(16);
+    shared_ptr<MessageQueue<MarketDataMessage>> queue = ring;
+
+    queue->push(MarketDataMessage{
+        .symbol = "AAPL",
+        .side = OrderSide::BUY,
+        .price = 150.0,
+        .quantity = 100,
+        .timestamp = chrono::system_clock::now()
+    });
+
+    MarketDataMessage msg;
+    ASSERT_TRUE(queue->tryPop(msg));
+    EXPECT_EQ(msg.symbol, "AAPL");
+    EXPECT_EQ(msg.quantity, 100);
+    EXPECT_TRUE(queue->empty());
+}
+
+TEST(SpscRingBufferTest, ProducerConsumerStressTest) {
+    SpscRingBuffer<int> queue(64);
+    const int totalMessages = 200000;
+
+    thread producer([&queue]() {
+        for (int i = 0; i < totalMessages; ++i) queue.push(i);
+    });
+
+    vector<int> received;
+    received.reserve(totalMessages);
+    thread consumer([&queue, &received]() {
+        int value = 0;
+        while (static_cast<int>(received.size()) < totalMessages) {
+            if (queue.tryPop(value)) received.push_back(value);
+            else this_thread::yield();
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    ASSERT_EQ(received.size(), totalMessages);
+    for (int i = 0; i < totalMessages; ++i) ASSERT_EQ(received[i], i);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscRingBufferTest, DrainToAcrossWrapAround) {
+    SpscRingBuffer<int> queue(8);
+    int value = 0;
+    for (int i = 0; i < 6; ++i) queue.push(i);
+    for (int i = 0; i < 6; ++i) queue.tryPop(value);
+    for (int i = 0; i < 8; ++i) ASSERT_TRUE(queue.tryPush(100 + i));
+
+    vector<int> batch;
+    EXPECT_EQ(queue.drainTo(batch, 5), 5);
+    EXPECT_EQ(batch, (vector<int>{100, 101, 102, 103, 104}));
+    EXPECT_EQ(queue.drainTo(batch, 100), 3);
+    EXPECT_EQ(batch.back(), 107);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscRingBufferTest, WaitPopParksUntilPushOrClose) {
+    SpscRingBuffer<int> queue(8);
+
+    thread producer([&queue]() {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        queue.push(7);
+    });
+
+    int value = 0;
+    EXPECT_TRUE(queue.waitPop(value, chrono::seconds(10)));
+    EXPECT_EQ(value, 7);
+    producer.join();
+
+    queue.close();
+    EXPECT_FALSE(queue.waitPop(value, chrono::seconds(10)));
+}
+
+TEST(SpscRingBufferTest, PushDropsOnceClosedAndFull) {
+    SpscRingBuffer<int> queue(4);
+    EXPECT_TRUE(queue.singleProducer());
+    queue.close();
+
+    // Pushes are still accepted while there is room, the consumer drains them on its way out
+    for (int i = 0; i < 4; ++i) queue.push(i);
+    queue.push(4); // would yield forever on an open ring
+    int moved = 5;
+    queue.push(std::move(moved));
+
+    EXPECT_EQ(queue.size(), 4);
+    EXPECT_EQ(queue.droppedAfterClose(), 2);
+}
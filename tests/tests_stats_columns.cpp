@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "../include/StatsColumns.h"
+#include "../include/MarketDataStatsTracker.h"
+
+#include "tests_helper.h"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+TEST(StatsColumnsTest, ColumnsFollowSnapshotOrder) {
+    MarketDataStatsTracker tracker;
+    tracker.update(makeMessage("COL_A", 100.0, 10));
+    tracker.update(makeMessage("COL_B", 50.0, 4));
+    tracker.update(makeMessage("COL_A", 110.0, 30));
+
+    auto snapshot = tracker.snapshot();
+    auto columns = StatsColumns::fromSnapshot(*snapshot);
+
+    ASSERT_EQ(columns.size(), snapshot->symbols.size());
+    EXPECT_EQ(columns.version, snapshot->version);
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const auto& [symbol, stats] = snapshot->symbols[i];
+        EXPECT_EQ(columns.symbols[i], symbol);
+        EXPECT_EQ(columns.lastPrice[i], stats.lastPrice.toDouble());
+        EXPECT_EQ(columns.volume[i], static_cast<double>(stats.totalVolume));
+        EXPECT_EQ(columns.notional[i], stats.getTotalNotional());
+    }
+}
+
+TEST(StatsColumnsTest, ComputesDerivedMetrics) {
+    MarketDataStatsTracker tracker;
+    tracker.update(makeMessage("COL_C", 100.0, 10));
+    tracker.update(makeMessage("COL_C", 110.0, 30));
+
+    auto columns = StatsColumns::fromSnapshot(*tracker.snapshot());
+    columns.computeDerived();
+
+    size_t index = 0;
+    while (columns.symbols[index] != "COL_C") ++index;
+    EXPECT_DOUBLE_EQ(columns.averagePrice[index], 107.5);
+    EXPECT_DOUBLE_EQ(columns.range[index], 10.0);
+    EXPECT_DOUBLE_EQ(columns.vwapDeviation[index], (110.0 - 107.5) / 107.5);
+}
+
+TEST(StatsColumnsTest, SymbolsWithoutVolumeDeriveZero) {
+    StatsColumns columns;
+    columns.add(Symbol("COL_EMPTY"), SymbolStats());
+    columns.computeDerived();
+
+    EXPECT_EQ(columns.averagePrice[0], 0.0);
+    EXPECT_EQ(columns.range[0], 0.0);
+    EXPECT_EQ(columns.vwapDeviation[0], 0.0);
+}
+
+TEST(StatsColumnsTest, VectorizedMatchesScalar) {
+    // An odd count so the vector loop leaves a scalar tail, with some idle symbols mixed in
+    StatsColumns columns;
+    for (int i = 0; i < 1003; ++i) {
+        SymbolStats stats;
+        if (i % 7 != 0) {
+            stats.update(makeMessage("COL_V" + to_string(i), 10.0 + i * 0.37, 1 + i % 13));
+            stats.update(makeMessage("COL_V" + to_string(i), 11.0 + i * 0.29, 2 + i % 5));
+        }
+        columns.add(Symbol("COL_V" + to_string(i)), stats);
+    }
+
+    StatsColumns scalar = columns;
+    columns.computeDerived();
+    scalar.computeDerivedScalar();
+
+    for (size_t i = 0; i < columns.size(); ++i) {
+        EXPECT_EQ(memcmp(&columns.averagePrice[i], &scalar.averagePrice[i], sizeof(double)), 0) << i;
+        EXPECT_EQ(memcmp(&columns.range[i], &scalar.range[i], sizeof(double)), 0) << i;
+        EXPECT_EQ(memcmp(&columns.vwapDeviation[i], &scalar.vwapDeviation[i], sizeof(double)), 0) << i;
+    }
+}
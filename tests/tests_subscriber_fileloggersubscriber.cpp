@@ -2,6 +2,7 @@
 
 #include "../include/testSubscribers/FileLoggerSubscriber.h"
 #include "../include/MarketDataMessage.h"
+#include "../include/SpscRingBuffer.h"
 #include "../utility/FilePathUtils.h"
 
 #include <chrono>
@@ -10,6 +11,9 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <filesystem>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
@@ -42,3 +46,105 @@ TEST(FileLoggerSubscriber, LogsMarketDataMessage) {
 
     EXPECT_TRUE(line.find("AAPL BUY 150.00 x100") != std::string::npos);
 }
+
+
+TEST(FileLoggerSubscriber, LogsThroughSpscRingBuffer) {
+    string filename = "tests/testlogs/filelogger/test_fileloggersubscriber_spsc.log";
+
+    FileLoggerSubscriber fileLogger(filename, make_unique<SpscRingBuffer<MarketDataMessage>>(64));
+
+    MarketDataMessage msg{
+        .symbol = "MSFT",
+        .side = OrderSide::SELL,
+        .price = 310.5,
+        .quantity = 25,
+        .timestamp = chrono::system_clock::now()
+    };
+
+    fileLogger.onMarketData(msg);
+    this_thread::sleep_for(100ms); // Allow for logging thread to process
+    fileLogger.stop();
+
+    auto absolutePath = getProjectRoot() / filename;
+    ifstream logFile(absolutePath.string());
+    ASSERT_TRUE(logFile.is_open()) << "Log file could not be opened: " << filename;
+
+    string line, lastLine;
+    while (getline(logFile, line)) lastLine = line;
+    logFile.close();
+
+    EXPECT_TRUE(lastLine.find("MSFT SELL 310.50 x25") != std::string::npos);
+}
+
+TEST(FileLoggerSubscriber, LogsWholeBatch) {
+    string filename = "tests/testlogs/filelogger/test_fileloggersubscriber_batch.log";
+    auto absolutePath = getProjectRoot() / filename;
+    filesystem::remove(absolutePath);
+
+    FileLoggerSubscriber fileLogger(filename);
+
+    vector<MarketDataMessage> batch;
+    for (int i = 1; i <= 25; ++i) {
+        batch.push_back(MarketDataMessage{
+            .symbol = "AMZN",
+            .side = OrderSide::BUY,
+            .price = 180.0,
+            .quantity = i,
+            .timestamp = chrono::system_clock::now()
+        });
+    }
+
+    fileLogger.onMarketDataBatch(batch);
+    fileLogger.stop(); // drains whatever is still queued
+
+    ifstream logFile(absolutePath.string());
+    ASSERT_TRUE(logFile.is_open()) << "Log file could not be opened: " << filename;
+
+    vector<string> lines;
+    string line;
+    while (getline(logFile, line)) lines.push_back(line);
+    logFile.close();
+
+    ASSERT_EQ(lines.size(), 25);
+    EXPECT_TRUE(lines.front().find("AMZN BUY 180.00 x1") != std::string::npos);
+    EXPECT_TRUE(lines.back().find("AMZN BUY 180.00 x25") != std::string::npos);
+}
+
+TEST(FileLoggerSubscriber, SpscQueueAcceptsSeveralProducers) {
+    string filename = "tests/testlogs/filelogger/test_fileloggersubscriber_spsc_producers.log";
+    auto absolutePath = getProjectRoot() / filename;
+    filesystem::remove(absolutePath);
+
+    // Sharded dispatchers call one logger from several threads, pushes into the ring are serialized
+    FileLoggerSubscriber fileLogger(filename, make_unique<SpscRingBuffer<MarketDataMessage>>(16));
+    vector<thread> dispatchers;
+    for (int t = 0; t < 4; ++t) {
+        dispatchers.emplace_back([&fileLogger] {
+            for (int i = 0; i < 500; ++i) {
+                fileLogger.onMarketData(MarketDataMessage{ .symbol = "NVDA", .side = OrderSide::BUY, .price = 120.0, .quantity = i });
+            }
+        });
+    }
+    for (auto& dispatcher : dispatchers) dispatcher.join();
+    fileLogger.stop();
+
+    ifstream logFile(absolutePath.string());
+    ASSERT_TRUE(logFile.is_open()) << "Log file could not be opened: " << filename;
+    size_t lines = 0;
+    string line;
+    while (getline(logFile, line)) ++lines;
+    EXPECT_EQ(lines, 2000);
+}
+
+TEST(FileLoggerSubscriber, SpscQueueDoesNotBlockAfterStop) {
+    string filename = "tests/testlogs/filelogger/test_fileloggersubscriber_spsc_stopped.log";
+
+    FileLoggerSubscriber fileLogger(filename, make_unique<SpscRingBuffer<MarketDataMessage>>(4));
+    fileLogger.stop();
+
+    // Nothing drains the ring any more, the fifth push used to spin forever
+    for (int i = 0; i < 10; ++i) {
+        fileLogger.onMarketData(MarketDataMessage{ .symbol = "AMD", .side = OrderSide::SELL, .price = 150.0, .quantity = i });
+    }
+    SUCCEED();
+}
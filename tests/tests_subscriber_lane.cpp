@@ -0,0 +1,315 @@
+#include <gtest/gtest.h>
+#include "../include/SubscriberLane.h"
+#include "../include/MarketDataFeedHandler.h"
+#include "../include/ThreadSafeMessageQueue.h"
+
+#include "tests_helper.h"
+
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class RecordingSubscriber : public IMarketDataSubscriber {
+public:
+    mutex mtx;
+    vector<MarketDataMessage> received;
+    atomic<int> count{0};
+
+    void onMarketData(const MarketDataMessage& message) override {
+        {
+            lock_guard<mutex> lock(mtx);
+            received.push_back(message);
+        }
+        ++count;
+    }
+};
+
+// Blocks inside its callback until released, standing in for a stalled console or disk sink
+class GatedSubscriber : public IMarketDataSubscriber {
+public:
+    mutex mtx;
+    condition_variable cv;
+    bool open = false;
+    atomic<int> count{0};
+
+    void onMarketData(const MarketDataMessage&) override {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [this] { return open; });
+        ++count;
+    }
+
+    void release() {
+        {
+            lock_guard<mutex> lock(mtx);
+            open = true;
+        }
+        cv.notify_all();
+    }
+};
+
+class ConflatedRecordingSubscriber : public IMarketDataSubscriber {
+public:
+    mutex mtx;
+    vector<ConflatedMarketData> updates;
+    atomic<int> plainMessages{0};
+
+    void onMarketData(const MarketDataMessage&) override {
+        ++plainMessages;
+    }
+
+    void onConflatedMarketData(const ConflatedMarketData& update) override {
+        lock_guard<mutex> lock(mtx);
+        updates.push_back(update);
+    }
+};
+
+TEST(SubscriberLaneTest, RequiresSubscriber) {
+    EXPECT_THROW(SubscriberLane(nullptr, SubscriptionOptions::asynchronous()), invalid_argument);
+}
+
+TEST(SubscriberLaneTest, DeliversInOrderOnLaneThread) {
+    auto subscriber = make_shared<RecordingSubscriber>();
+    auto lane = make_shared<SubscriberLane>(subscriber, SubscriptionOptions::asynchronous(64, OverflowPolicy::BLOCK));
+    lane->start();
+
+    for (int i = 0; i < 100; ++i) lane->onMarketData(makeMessage("AAPL", 100.0 + i, i));
+    lane->stop();
+
+    ASSERT_EQ(subscriber->received.size(), 100);
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(subscriber->received[i].quantity, i);
+
+    auto stats = lane->getStats();
+    EXPECT_EQ(stats.delivered, 100);
+    EXPECT_EQ(stats.queueDepth, 0);
+    EXPECT_EQ(stats.drops.totalDropped(), 0);
+    EXPECT_GE(stats.maxLag, stats.lastLag);
+}
+
+TEST(SubscriberLaneTest, DropsOldestWhenSubscriberFallsBehind) {
+    auto subscriber = make_shared<GatedSubscriber>();
+    auto lane = make_shared<SubscriberLane>(subscriber, SubscriptionOptions::asynchronous(4, OverflowPolicy::DROP_OLDEST));
+    lane->start();
+
+    lane->onMarketData(makeMessage("AAPL", 100.0, 1));
+    ASSERT_TRUE(waitFor([&] { return lane->getStats().queueDepth == 0; })); // first message is stuck in the callback
+
+    for (int i = 0; i < 10; ++i) lane->onMarketData(makeMessage("AAPL", 100.0, i));
+
+    auto stats = lane->getStats();
+    EXPECT_EQ(stats.queueDepth, 4);
+    EXPECT_EQ(stats.drops.droppedOldest, 6);
+    EXPECT_EQ(stats.delivered, 0);
+
+    subscriber->release();
+    lane->stop();
+    EXPECT_EQ(subscriber->count.load(), 5);
+    EXPECT_EQ(lane->getStats().delivered, 5);
+}
+
+TEST(SubscriberLaneTest, ConflatesBySymbol) {
+    auto subscriber = make_shared<GatedSubscriber>();
+    auto lane = make_shared<SubscriberLane>(subscriber, SubscriptionOptions::asynchronous(8, OverflowPolicy::CONFLATE));
+    lane->start();
+
+    lane->onMarketData(makeMessage("AAPL", 100.0, 1));
+    ASSERT_TRUE(waitFor([&] { return lane->getStats().queueDepth == 0; }));
+
+    for (int i = 0; i < 5; ++i) {
+        lane->onMarketData(makeMessage("AAPL", 100.0 + i, 1));
+        lane->onMarketData(makeMessage("MSFT", 300.0 + i, 1));
+    }
+
+    EXPECT_EQ(lane->getStats().queueDepth, 2);
+    EXPECT_EQ(lane->getStats().drops.conflated, 8);
+
+    subscriber->release();
+    lane->stop();
+}
+
+TEST(SubscriberLaneTest, SlowSubscriberDoesNotStallOthers) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandler handler(queue);
+
+    auto slow = make_shared<GatedSubscriber>();
+    auto fast = make_shared<RecordingSubscriber>();
+    handler.subscribe(slow, SubscriptionOptions::asynchronous(16, OverflowPolicy::DROP_OLDEST));
+    handler.subscribe(fast);
+    handler.start();
+
+    for (int i = 0; i < 200; ++i) queue->push(makeMessage("JPM", 150.0, i));
+
+    EXPECT_TRUE(waitFor([&] { return fast->count.load() == 200; }));
+    EXPECT_EQ(handler.getStatsTracker()->getStats("JPM").tradeCount, 200);
+
+    auto stats = handler.getLaneStats(slow);
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_LE(stats->queueDepth, 16);
+    EXPECT_GT(stats->drops.droppedOldest, 0);
+
+    EXPECT_FALSE(handler.getLaneStats(fast).has_value());
+
+    slow->release();
+    handler.stop();
+}
+
+TEST(SubscriberLaneTest, UnsubscribeFlushesLane) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandler handler(queue);
+
+    auto subscriber = make_shared<RecordingSubscriber>();
+    handler.subscribe(subscriber, SubscriptionOptions::asynchronous(1024, OverflowPolicy::BLOCK));
+    handler.start();
+
+    for (int i = 0; i < 100; ++i) queue->push(makeMessage("GS", 400.0, i));
+    ASSERT_TRUE(waitFor([&] { return handler.getStatsTracker()->getStats("GS").tradeCount == 100; }));
+
+    handler.unsubscribe(subscriber);
+    EXPECT_EQ(subscriber->count.load(), 100);
+    EXPECT_FALSE(handler.getLaneStats(subscriber).has_value());
+
+    queue->push(makeMessage("GS", 400.0, 1));
+    handler.stop();
+    EXPECT_EQ(subscriber->count.load(), 100);
+}
+
+TEST(SubscriberLaneTest, PushesRacingStopAreDeliveredOrCounted) {
+    for (int round = 0; round < 20; ++round) {
+        auto subscriber = make_shared<RecordingSubscriber>();
+        auto lane = make_shared<SubscriberLane>(subscriber, SubscriptionOptions::asynchronous(1 << 16, OverflowPolicy::DROP_NEWEST));
+        lane->start();
+
+        // Stands in for a dispatcher still holding the subscriber snapshot that had this lane
+        atomic<bool> stopped{false};
+        atomic<int> offered{0};
+        thread producer([&] {
+            for (int afterStop = 0; afterStop < 100; afterStop += stopped.load() ? 1 : 0) {
+                lane->onMarketData(makeMessage("MS", 90.0, offered.load()));
+                ++offered;
+            }
+        });
+        while (offered.load() < 100) this_thread::yield();
+        lane->stop();
+        stopped = true;
+        producer.join();
+
+        const auto stats = lane->getStats();
+        EXPECT_GT(stats.drops.droppedNewest, 0u);
+        EXPECT_EQ(subscriber->count.load() + stats.drops.totalDropped(), static_cast<uint64_t>(offered.load()));
+        EXPECT_EQ(stats.queueDepth, 0u);
+    }
+}
+
+TEST(SubscriberLaneTest, SubscriberCanUnsubscribeFromItsOwnLane) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandler handler(queue);
+
+    class SelfRemovingSubscriber : public IMarketDataSubscriber {
+    public:
+        MarketDataFeedHandler* handler = nullptr;
+        weak_ptr<IMarketDataSubscriber> self;
+        atomic<int> count{0};
+
+        void onMarketData(const MarketDataMessage&) override {
+            if (++count == 1) handler->unsubscribe(self.lock());
+        }
+    };
+
+    auto subscriber = make_shared<SelfRemovingSubscriber>();
+    subscriber->handler = &handler;
+    subscriber->self = subscriber;
+    handler.subscribe(subscriber, SubscriptionOptions::asynchronous());
+    handler.start();
+
+    queue->push(makeMessage("MS", 90.0, 1));
+    ASSERT_TRUE(waitFor([&] { return subscriber->count.load() >= 1; }));
+    ASSERT_TRUE(waitFor([&] { return !handler.getLaneStats(subscriber).has_value(); }));
+
+    handler.stop();
+    EXPECT_EQ(subscriber->count.load(), 1);
+}
+
+TEST(SubscriberLaneTest, ConflatedLaneAccumulatesVolumeAndCount) {
+    auto gate = make_shared<GatedSubscriber>();
+    auto subscriber = make_shared<ConflatedRecordingSubscriber>();
+
+    // Hold the lane thread inside the first callback so the rest piles up behind it
+    class BlockFirstSubscriber : public IMarketDataSubscriber {
+    public:
+        shared_ptr<GatedSubscriber> gate;
+        shared_ptr<ConflatedRecordingSubscriber> inner;
+        atomic<bool> first{true};
+
+        void onMarketData(const MarketDataMessage& message) override {}
+
+        void onConflatedMarketData(const ConflatedMarketData& update) override {
+            if (first.exchange(false)) gate->onMarketData(update.latest);
+            inner->onConflatedMarketData(update);
+        }
+    };
+
+    auto blocking = make_shared<BlockFirstSubscriber>();
+    blocking->gate = gate;
+    blocking->inner = subscriber;
+
+    auto lane = make_shared<SubscriberLane>(blocking, SubscriptionOptions::conflated());
+    lane->start();
+
+    lane->onMarketData(makeMessage("AAPL", 100.0, 1));
+    ASSERT_TRUE(waitFor([&] { return lane->getStats().queueDepth == 0; }));
+
+    for (int i = 1; i <= 10; ++i) {
+        lane->onMarketData(makeMessage("AAPL", 100.0 + i, i));
+        lane->onMarketData(makeMessage("MSFT", 300.0 + i, 2));
+    }
+    EXPECT_EQ(lane->getStats().queueDepth, 2);
+
+    gate->release();
+    lane->stop();
+
+    ASSERT_EQ(subscriber->updates.size(), 3);
+    EXPECT_EQ(subscriber->updates[0].messageCount, 1);
+
+    const auto& aapl = subscriber->updates[1];
+    EXPECT_EQ(aapl.latest.symbol, "AAPL");
+    EXPECT_DOUBLE_EQ(aapl.latest.price, 110.0);
+    EXPECT_EQ(aapl.accumulatedVolume, 55);
+    EXPECT_EQ(aapl.messageCount, 10);
+
+    const auto& msft = subscriber->updates[2];
+    EXPECT_EQ(msft.latest.symbol, "MSFT");
+    EXPECT_EQ(msft.accumulatedVolume, 20);
+    EXPECT_EQ(msft.messageCount, 10);
+
+    auto stats = lane->getStats();
+    EXPECT_EQ(stats.delivered, 3);
+    EXPECT_EQ(stats.drops.conflated, 18);
+}
+
+TEST(SubscriberLaneTest, ConflatedSubscriptionKeepsFullStats) {
+    auto queue = make_shared<ThreadSafeMessageQueue<MarketDataMessage>>();
+    MarketDataFeedHandler handler(queue);
+
+    auto subscriber = make_shared<ConflatedRecordingSubscriber>();
+    handler.subscribe(subscriber, SubscriptionOptions::conflated());
+    handler.start();
+
+    for (int i = 0; i < 500; ++i) queue->push(makeMessage(i % 2 ? "AMD" : "NVDA", 100.0, 1));
+    ASSERT_TRUE(waitFor([&] { return handler.getStatsTracker()->getStats("AMD").tradeCount == 250; }));
+    handler.stop();
+    handler.unsubscribe(subscriber); // flushes anything still pending
+
+    // However many updates were conflated, the delivered counts add up to every message
+    int64_t volume = 0;
+    for (const auto& update : subscriber->updates) volume += update.accumulatedVolume;
+    EXPECT_EQ(volume, 500);
+    EXPECT_LE(subscriber->updates.size(), 500);
+    EXPECT_EQ(subscriber->plainMessages.load(), 0);
+    EXPECT_EQ(handler.getStatsTracker()->getStats("NVDA").tradeCount, 250);
+}
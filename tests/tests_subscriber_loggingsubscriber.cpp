@@ -4,6 +4,7 @@
 #include "../include/MarketDataMessage.h"
 
 #include <chrono>
+#include <vector>
 
 using namespace std;
 
@@ -27,3 +28,17 @@ TEST(LoggingSubscriber, LogMessage) {
     EXPECT_EQ(output, expectedOutput);
 }
 
+
+TEST(LoggingSubscriber, LogBatch) {
+    LoggingSubscriber subscriber;
+
+    vector<MarketDataMessage> batch = {
+        MarketDataMessage{ .symbol = "AAPL", .side = OrderSide::BUY, .price = 150.0, .quantity = 100, .timestamp = chrono::system_clock::now() },
+        MarketDataMessage{ .symbol = "MSFT", .side = OrderSide::SELL, .price = 310.5, .quantity = 20, .timestamp = chrono::system_clock::now() }
+    };
+
+    testing::internal::CaptureStdout();
+    subscriber.onMarketDataBatch(batch);
+    string output = testing::internal::GetCapturedStdout();
+    EXPECT_EQ(output, "[LOG] AAPL BUY @150.00 x100\n[LOG] MSFT SELL @310.50 x20\n");
+}
@@ -6,7 +6,13 @@
 #include "../include/MarketDataStatsTracker.h"
 #include "../include/SymbolStats.h"
 
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
@@ -145,4 +151,331 @@ TEST(MarketStatsDataSubscriber, HandlesMultipleUpdates) {
     EXPECT_EQ(stats.tradeCount, 10);
     EXPECT_EQ(stats.highPrice, 159.0);
     EXPECT_EQ(stats.lowPrice, 150.0);
-}
\ No newline at end of file
+}
+TEST(MarketStatsDataSubscriber, BatchUpdateMatchesSingleUpdates) {
+    auto batchTracker = make_shared<MarketDataStatsTracker>();
+    auto singleTracker = make_shared<MarketDataStatsTracker>();
+
+    vector<MarketDataMessage> batch;
+    for (int i = 0; i < 10; ++i) {
+        batch.push_back(MarketDataMessage{
+            .symbol = (i % 2 == 0)? "AAPL" : "MSFT",
+            .side = OrderSide::BUY,
+            .price = 100.0 + i,
+            .quantity = 1 + i,
+            .timestamp = chrono::system_clock::now()
+        });
+        singleTracker->update(batch.back());
+    }
+    batchTracker->update(batch);
+
+    for (const string symbol : {"AAPL", "MSFT"}) {
+        auto fromBatch = batchTracker->getStats(symbol);
+        auto fromSingle = singleTracker->getStats(symbol);
+        EXPECT_EQ(fromBatch.tradeCount, fromSingle.tradeCount);
+        EXPECT_EQ(fromBatch.totalVolume, fromSingle.totalVolume);
+        EXPECT_EQ(fromBatch.lastPrice, fromSingle.lastPrice);
+        EXPECT_DOUBLE_EQ(fromBatch.getAveragePrice(), fromSingle.getAveragePrice());
+    }
+}
+
+TEST(MarketStatsDataSubscriber, ReadersSeeConsistentStatsDuringUpdates) {
+    auto statsTracker = make_shared<MarketDataStatsTracker>();
+    atomic<bool> writing{true};
+    atomic<int> tornReads{0};
+
+    // Every message has quantity 1 and price == its trade number, so a consistent snapshot
+    // always has totalVolume == tradeCount == lastPrice == highPrice
+    thread writer([&] {
+        for (int i = 1; i <= 20000; ++i) {
+            statsTracker->update(MarketDataMessage{
+                .symbol = "SEQ",
+                .side = OrderSide::BUY,
+                .price = static_cast<double>(i),
+                .quantity = 1,
+                .timestamp = chrono::system_clock::now()
+            });
+        }
+        writing = false;
+    });
+
+    vector<thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            while (writing) {
+                auto stats = statsTracker->getStats("SEQ");
+                if (stats.tradeCount == 0) continue;
+                if (stats.totalVolume != stats.tradeCount || stats.lastPrice != static_cast<double>(stats.tradeCount)
+                    || stats.highPrice != stats.lastPrice || stats.lowPrice != 1.0) ++tornReads;
+            }
+        });
+    }
+
+    writer.join();
+    for (auto& reader : readers) reader.join();
+
+    EXPECT_EQ(tornReads.load(), 0);
+    EXPECT_EQ(statsTracker->getStats("SEQ").tradeCount, 20000);
+    EXPECT_EQ(statsTracker->getAllSymbols(), vector<string>{"SEQ"});
+}
+
+TEST(MarketStatsDataSubscriber, ConcurrentWritersToOneSymbolAreSerialized) {
+    auto statsTracker = make_shared<MarketDataStatsTracker>();
+
+    vector<thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&statsTracker] {
+            for (int i = 0; i < 5000; ++i) {
+                statsTracker->update(MarketDataMessage{
+                    .symbol = "MULTI",
+                    .side = OrderSide::SELL,
+                    .price = 10.0,
+                    .quantity = 2,
+                    .timestamp = chrono::system_clock::now()
+                });
+            }
+        });
+    }
+    for (auto& writer : writers) writer.join();
+
+    auto stats = statsTracker->getStats("MULTI");
+    EXPECT_EQ(stats.tradeCount, 20000);
+    EXPECT_EQ(stats.totalVolume, 40000);
+    EXPECT_EQ(statsTracker->getAllSymbols().size(), 1);
+}
+
+TEST(MarketStatsDataSubscriber, SnapshotHoldsEverySymbolAndIsShared) {
+    auto statsTracker = make_shared<MarketDataStatsTracker>();
+    EXPECT_TRUE(statsTracker->snapshot()->symbols.empty());
+
+    for (const char* symbol : {"SNAPA", "SNAPB", "SNAPC"}) {
+        statsTracker->update(MarketDataMessage{
+            .symbol = symbol,
+            .side = OrderSide::BUY,
+            .price = 10.0,
+            .quantity = 5,
+            .timestamp = chrono::system_clock::now()
+        });
+    }
+
+    auto first = statsTracker->snapshot();
+    ASSERT_EQ(first->symbols.size(), 3);
+    EXPECT_TRUE(first->consistent);
+    EXPECT_EQ(first->symbols[0].first, "SNAPA");
+    EXPECT_EQ(first->symbols[2].first, "SNAPC");
+    ASSERT_NE(first->find("SNAPB"), nullptr);
+    EXPECT_EQ(first->find("SNAPB")->totalVolume, 5);
+    EXPECT_EQ(first->find("NOPE"), nullptr);
+
+    // No updates in between: the same immutable snapshot is handed out again
+    EXPECT_EQ(statsTracker->snapshot(), first);
+
+    statsTracker->update(MarketDataMessage{ .symbol = "SNAPA", .side = OrderSide::BUY, .price = 12.0, .quantity = 1 });
+    auto second = statsTracker->snapshot();
+    EXPECT_NE(second, first);
+    EXPECT_GT(second->version, first->version);
+    EXPECT_EQ(second->find("SNAPA")->tradeCount, 2);
+    EXPECT_EQ(first->find("SNAPA")->tradeCount, 1); // older snapshots never change
+}
+
+TEST(MarketStatsDataSubscriber, SnapshotNeverSeesHalfABatch) {
+    auto statsTracker = make_shared<MarketDataStatsTracker>();
+    atomic<bool> writing{true};
+    atomic<int> consistentSnapshots{0};
+    atomic<int> tornSnapshots{0};
+
+    // Every batch carries one trade for each of the two symbols, so their volumes always match
+    thread writer([&] {
+        for (int i = 1; i <= 5000; ++i) {
+            vector<MarketDataMessage> batch;
+            for (const char* symbol : {"PAIRA", "PAIRB"}) {
+                batch.push_back(MarketDataMessage{
+                    .symbol = symbol,
+                    .side = OrderSide::BUY,
+                    .price = 1.0,
+                    .quantity = i,
+                    .timestamp = chrono::system_clock::now()
+                });
+            }
+            statsTracker->update(batch);
+        }
+        writing = false;
+    });
+
+    thread reader([&] {
+        while (writing) {
+            auto snapshot = statsTracker->snapshot();
+            if (!snapshot->consistent) continue;
+            ++consistentSnapshots;
+
+            const SymbolStats* a = snapshot->find("PAIRA");
+            const SymbolStats* b = snapshot->find("PAIRB");
+            if (!a && !b) continue;
+            if (!a || !b || a->totalVolume != b->totalVolume) ++tornSnapshots;
+        }
+    });
+
+    writer.join();
+    reader.join();
+
+    EXPECT_EQ(tornSnapshots.load(), 0);
+    auto last = statsTracker->snapshot();
+    EXPECT_TRUE(last->consistent);
+    EXPECT_EQ(last->find("PAIRA")->tradeCount, 5000);
+}
+
+TEST(MarketStatsDataSubscriber, SnapshotIsFilledWhileWritersNeverPause) {
+    auto statsTracker = make_shared<MarketDataStatsTracker>();
+    statsTracker->update(MarketDataMessage{ .symbol = "BUSY0", .side = OrderSide::BUY, .price = 1.0, .quantity = 1 });
+
+    // Four writers keep an update in flight almost all the time, as sharded dispatch does
+    atomic<bool> writing{true};
+    vector<thread> writers;
+    for (int w = 0; w < 4; ++w) {
+        writers.emplace_back([&, w] {
+            const vector<MarketDataMessage> batch(64, MarketDataMessage{ .symbol = "BUSY" + to_string(w), .side = OrderSide::BUY, .price = 1.0, .quantity = 1 });
+            while (writing) statsTracker->update(batch);
+        });
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        auto snapshot = statsTracker->snapshot();
+        ASSERT_FALSE(snapshot->symbols.empty()) << "attempt " << i;
+        ASSERT_NE(snapshot->find("BUSY0"), nullptr);
+    }
+    writing = false;
+    for (auto& writer : writers) writer.join();
+
+    EXPECT_TRUE(statsTracker->snapshot()->consistent);
+}
+
+TEST(MarketStatsDataSubscriber, TracksVarianceAndRealizedVolatility) {
+    MarketDataStatsTracker tracker;
+    const auto start = chrono::system_clock::now();
+    const double prices[] = { 100.0, 102.0, 101.0, 103.0, 99.0 };
+    for (int i = 0; i < 5; ++i) {
+        tracker.update(MarketDataMessage{ .symbol = "VOL1", .side = OrderSide::BUY, .price = prices[i], .quantity = 1, .timestamp = start + chrono::seconds(i) });
+    }
+
+    auto stats = tracker.getStats("VOL1");
+
+    // Sample variance of 100, 102, 101, 103, 99 around a mean of 101
+    EXPECT_DOUBLE_EQ(stats.priceMean, 101.0);
+    EXPECT_NEAR(stats.getPriceVariance(), 2.5, 1e-12);
+    EXPECT_NEAR(stats.getPriceStdDev(), sqrt(2.5), 1e-12);
+
+    double sumSquares = 0.0;
+    for (int i = 1; i < 5; ++i) sumSquares += pow(log(prices[i] / prices[i - 1]), 2);
+    EXPECT_NEAR(stats.getRealizedVolatility(), sqrt(sumSquares), 1e-12);
+}
+
+TEST(MarketStatsDataSubscriber, PriceEwmaDecaysByHalfLife) {
+    MarketDataStatsTrackerConfig config;
+    config.priceEwmas = { { "1s", chrono::seconds(1) }, { "1m", chrono::seconds(60) } };
+    MarketDataStatsTracker tracker(config);
+    EXPECT_EQ(tracker.getPriceEwmaNames(), (vector<string>{ "1s", "1m" }));
+
+    const auto start = chrono::system_clock::now();
+    tracker.update(MarketDataMessage{ .symbol = "EWM1", .side = OrderSide::BUY, .price = 100.0, .quantity = 1, .timestamp = start });
+    EXPECT_DOUBLE_EQ(tracker.getStats("EWM1").priceEwma[0], 100.0);
+
+    // One half-life later the short EWMA has moved half way to the new price, the long one barely at all
+    tracker.update(MarketDataMessage{ .symbol = "EWM1", .side = OrderSide::BUY, .price = 200.0, .quantity = 1, .timestamp = start + chrono::seconds(1) });
+    auto stats = tracker.getStats("EWM1");
+    EXPECT_NEAR(stats.priceEwma[0], 150.0, 1e-9);
+    EXPECT_NEAR(stats.priceEwma[1], 100.0 + 100.0 * (1.0 - pow(0.5, 1.0 / 60.0)), 1e-9);
+
+    // An out of order trade is treated as simultaneous and leaves the EWMA where it was
+    tracker.update(MarketDataMessage{ .symbol = "EWM1", .side = OrderSide::BUY, .price = 500.0, .quantity = 1, .timestamp = start });
+    EXPECT_NEAR(tracker.getStats("EWM1").priceEwma[0], 150.0, 1e-9);
+}
+
+TEST(MarketStatsDataSubscriber, TradeRateTracksSteadyFlow) {
+    MarketDataStatsTrackerConfig config;
+    config.tradeRateHalfLife = chrono::seconds(10);
+    MarketDataStatsTracker tracker(config);
+
+    // 50 trades a second for two minutes, well past the half-life
+    const auto start = chrono::system_clock::now();
+    for (int i = 0; i < 6000; ++i) {
+        tracker.update(MarketDataMessage{ .symbol = "RATE1", .side = OrderSide::BUY, .price = 10.0, .quantity = 1, .timestamp = start + chrono::milliseconds(20 * i) });
+    }
+    EXPECT_NEAR(tracker.getStats("RATE1").tradeRate, 50.0, 1.0);
+}
+
+TEST(MarketStatsDataSubscriber, RejectsBadAnalyticsConfig) {
+    MarketDataStatsTrackerConfig tooMany;
+    tooMany.priceEwmas = { { "a", chrono::seconds(1) }, { "b", chrono::seconds(2) }, { "c", chrono::seconds(3) }, { "d", chrono::seconds(4) }, { "e", chrono::seconds(5) } };
+    EXPECT_THROW(MarketDataStatsTracker tracker(tooMany), invalid_argument);
+
+    MarketDataStatsTrackerConfig zero;
+    zero.priceEwmas = { { "a", chrono::seconds(0) } };
+    EXPECT_THROW(MarketDataStatsTracker tracker(zero), invalid_argument);
+
+    MarketDataStatsTrackerConfig duplicate;
+    duplicate.priceEwmas = { { "a", chrono::seconds(1) }, { "a", chrono::seconds(2) } };
+    EXPECT_THROW(MarketDataStatsTracker tracker(duplicate), invalid_argument);
+
+    MarketDataStatsTrackerConfig noRate;
+    noRate.tradeRateHalfLife = chrono::milliseconds(0);
+    EXPECT_THROW(MarketDataStatsTracker tracker(noRate), invalid_argument);
+}
+
+TEST(MarketStatsDataSubscriber, AggregatesEachSide) {
+    MarketDataStatsTracker tracker;
+    const auto now = chrono::system_clock::now();
+    tracker.update(MarketDataMessage{ .symbol = "SIDE1", .side = OrderSide::BUY, .price = 10.0, .quantity = 100, .timestamp = now });
+    tracker.update(MarketDataMessage{ .symbol = "SIDE1", .side = OrderSide::SELL, .price = 11.0, .quantity = 50, .timestamp = now });
+    tracker.update(MarketDataMessage{ .symbol = "SIDE1", .side = OrderSide::BUY, .price = 12.0, .quantity = 30, .timestamp = now });
+
+    auto stats = tracker.getStats("SIDE1");
+    EXPECT_EQ(stats.buyVolume, 130);
+    EXPECT_EQ(stats.sellVolume, 50);
+    EXPECT_EQ(stats.buyCount, 2);
+    EXPECT_EQ(stats.sellCount, 1);
+    EXPECT_DOUBLE_EQ(stats.getBuyNotional(), 1360.0);
+    EXPECT_DOUBLE_EQ(stats.getSellNotional(), 550.0);
+    EXPECT_DOUBLE_EQ(stats.getOrderFlowImbalance(), 80.0 / 180.0);
+}
+
+TEST(MarketStatsDataSubscriber, ClassifiesUnknownSideByTickRule) {
+    const auto now = chrono::system_clock::now();
+    auto feed = [&](MarketDataStatsTracker& tracker) {
+        for (double price : { 10.0, 11.0, 11.0, 10.5 }) {
+            tracker.update(MarketDataMessage{ .symbol = "TICK1", .side = OrderSide::UNKNOWN, .price = price, .quantity = 10, .timestamp = now });
+        }
+    };
+
+    MarketDataStatsTracker tracker;
+    feed(tracker);
+    auto stats = tracker.getStats("TICK1");
+    EXPECT_EQ(stats.buyCount, 2);   // uptick, then a zero tick after it
+    EXPECT_EQ(stats.sellCount, 1);  // downtick
+    EXPECT_EQ(stats.buyVolume + stats.sellVolume, 30); // the first trade has no prior tick to go by
+    EXPECT_EQ(stats.totalVolume, 40);
+
+    MarketDataStatsTrackerConfig config;
+    config.tickRule = false;
+    MarketDataStatsTracker unclassified(config);
+    feed(unclassified);
+    EXPECT_EQ(unclassified.getStats("TICK1").buyCount + unclassified.getStats("TICK1").sellCount, 0);
+    EXPECT_EQ(unclassified.getStats("TICK1").getOrderFlowImbalance(), 0.0);
+}
+
+TEST(MarketStatsDataSubscriber, OrderFlowImbalanceDecays) {
+    MarketDataStatsTrackerConfig config;
+    config.orderFlowHalfLife = chrono::seconds(60);
+    MarketDataStatsTracker tracker(config);
+
+    const auto now = chrono::system_clock::now();
+    tracker.update(MarketDataMessage{ .symbol = "OFI1", .side = OrderSide::BUY, .price = 10.0, .quantity = 100, .timestamp = now });
+    EXPECT_DOUBLE_EQ(tracker.getStats("OFI1").getOrderFlowImbalance(), 1.0);
+
+    // A half-life later the earlier buying weighs 50 against 100 fresh sells
+    tracker.update(MarketDataMessage{ .symbol = "OFI1", .side = OrderSide::SELL, .price = 10.0, .quantity = 100, .timestamp = now + chrono::seconds(60) });
+    EXPECT_NEAR(tracker.getStats("OFI1").getOrderFlowImbalance(), -50.0 / 150.0, 1e-12);
+
+    MarketDataStatsTrackerConfig bad;
+    bad.orderFlowHalfLife = chrono::seconds(0);
+    EXPECT_THROW(MarketDataStatsTracker rejected(bad), invalid_argument);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "../include/Symbol.h"
+#include "../include/MarketDataMessage.h"
+
+#include <thread>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+using namespace std;
+
+TEST(SymbolTest, DefaultIsEmpty) {
+    Symbol symbol;
+    EXPECT_TRUE(symbol.empty());
+    EXPECT_EQ(symbol.id(), 0);
+    EXPECT_EQ(symbol.str(), "");
+}
+
+TEST(SymbolTest, SameNameSameId) {
+    Symbol a("AAPL");
+    Symbol b(string("AAPL"));
+    Symbol c = "MSFT";
+
+    EXPECT_EQ(a.id(), b.id());
+    EXPECT_NE(a.id(), c.id());
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(a != c);
+    EXPECT_EQ(a.str(), "AAPL");
+    EXPECT_EQ(Symbol::fromId(c.id()).str(), "MSFT");
+}
+
+TEST(SymbolTest, ComparesWithStrings) {
+    Symbol symbol("GOOGL");
+    EXPECT_TRUE(symbol == "GOOGL");
+    EXPECT_TRUE("GOOGL" == symbol);
+    EXPECT_TRUE(symbol == string("GOOGL"));
+    EXPECT_TRUE(symbol != "GOOG");
+
+    const string& name = symbol;
+    EXPECT_EQ(name, "GOOGL");
+
+    ostringstream os;
+    os << symbol;
+    EXPECT_EQ(os.str(), "GOOGL");
+}
+
+TEST(SymbolTest, FindAndCompareDoNotIntern) {
+    EXPECT_FALSE(SymbolTable::instance().find("NOT_A_REAL_TICKER").has_value());
+
+    Symbol tsla("TSLA");
+    const size_t before = SymbolTable::instance().size();
+    EXPECT_FALSE(tsla == "NOT_A_REAL_TICKER");
+    EXPECT_EQ(SymbolTable::instance().size(), before);
+    EXPECT_FALSE(SymbolTable::instance().find("NOT_A_REAL_TICKER").has_value());
+    EXPECT_EQ(SymbolTable::instance().find("TSLA").value(), tsla.id());
+}
+
+TEST(SymbolTest, MessageCarriesCompactSymbol) {
+    EXPECT_EQ(sizeof(Symbol), sizeof(SymbolId));
+
+    MarketDataMessage msg{
+        .symbol = "IBM",
+        .side = OrderSide::BUY,
+        .price = 180.0,
+        .quantity = 10,
+        .timestamp = chrono::system_clock::now()
+    };
+    EXPECT_EQ(msg.symbol, "IBM");
+
+    unordered_set<Symbol> seen = {msg.symbol, Symbol("IBM"), Symbol("ORCL")};
+    EXPECT_EQ(seen.size(), 2);
+}
+
+TEST(SymbolTest, ConcurrentInterningAgrees) {
+    const int numThreads = 8;
+    const int numSymbols = 5000; // spans more than one storage chunk
+
+    vector<vector<SymbolId>> ids(numThreads, vector<SymbolId>(numSymbols));
+    vector<thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&ids, t]() {
+            for (int i = 0; i < numSymbols; ++i) {
+                int index = (i + t * 613) % numSymbols;
+                ids[t][index] = Symbol("CONC" + to_string(index)).id();
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    unordered_set<SymbolId> distinct;
+    for (int i = 0; i < numSymbols; ++i) {
+        for (int t = 1; t < numThreads; ++t) ASSERT_EQ(ids[t][i], ids[0][i]);
+        EXPECT_EQ(Symbol::fromId(ids[0][i]).str(), "CONC" + to_string(i));
+        distinct.insert(ids[0][i]);
+    }
+    EXPECT_EQ(distinct.size(), numSymbols);
+}
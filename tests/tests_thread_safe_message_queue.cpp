@@ -144,4 +144,108 @@ TEST(ThreadSafeMessageQueueTest, StressTest) {
     EXPECT_TRUE(queue.empty());
     EXPECT_EQ(queue.size(), 0);
     EXPECT_THROW(queue.top(), runtime_error); 
-}
\ No newline at end of file
+}
+
+TEST(ThreadSafeMessageQueueTest, DrainToTakesUpToMaxItems) {
+    ThreadSafeMessageQueue<int> queue;
+    for (int i = 0; i < 10; ++i) queue.push(i);
+
+    vector<int> batch;
+    EXPECT_EQ(queue.drainTo(batch, 4), 4);
+    EXPECT_EQ(batch, (vector<int>{0, 1, 2, 3}));
+    EXPECT_EQ(queue.size(), 6);
+
+    // drainTo appends to whatever is already in the container
+    EXPECT_EQ(queue.drainTo(batch, 100), 6);
+    EXPECT_EQ(batch.size(), 10);
+    EXPECT_EQ(batch.back(), 9);
+    EXPECT_TRUE(queue.empty());
+
+    EXPECT_EQ(queue.drainTo(batch, 100), 0);
+}
+
+TEST(ThreadSafeMessageQueueTest, PopBatch) {
+    ThreadSafeMessageQueue<int> queue;
+    for (int i = 0; i < 5; ++i) queue.push(i);
+
+    auto batch = queue.popBatch(3);
+    EXPECT_EQ(batch, (vector<int>{0, 1, 2}));
+    EXPECT_EQ(queue.size(), 2);
+}
+
+TEST(ThreadSafeMessageQueueTest, WaitPopTimesOutOnEmptyQueue) {
+    ThreadSafeMessageQueue<int> queue;
+    int value = 0;
+
+    auto start = chrono::steady_clock::now();
+    EXPECT_FALSE(queue.waitPop(value, chrono::milliseconds(50)));
+    EXPECT_GE(chrono::steady_clock::now() - start, chrono::milliseconds(50));
+}
+
+TEST(ThreadSafeMessageQueueTest, WaitPopWakesOnPush) {
+    ThreadSafeMessageQueue<int> queue;
+
+    thread producer([&queue]() {
+        this_thread::sleep_for(chrono::milliseconds(50));
+        queue.push(42);
+    });
+
+    int value = 0;
+    auto start = chrono::steady_clock::now();
+    EXPECT_TRUE(queue.waitPop(value, chrono::seconds(10)));
+    EXPECT_LT(chrono::steady_clock::now() - start, chrono::seconds(5));
+    EXPECT_EQ(value, 42);
+
+    producer.join();
+}
+
+TEST(ThreadSafeMessageQueueTest, CloseWakesBlockedConsumers) {
+    ThreadSafeMessageQueue<int> queue;
+
+    vector<thread> consumers;
+    atomic<int> woken{0};
+    for (int i = 0; i < 4; ++i) {
+        consumers.emplace_back([&queue, &woken]() {
+            int value = 0;
+            EXPECT_FALSE(queue.waitPop(value, chrono::seconds(10)));
+            ++woken;
+        });
+    }
+
+    this_thread::sleep_for(chrono::milliseconds(50));
+    auto start = chrono::steady_clock::now();
+    queue.close();
+    for (auto& consumer : consumers) consumer.join();
+
+    EXPECT_EQ(woken.load(), 4);
+    EXPECT_LT(chrono::steady_clock::now() - start, chrono::seconds(5));
+    EXPECT_TRUE(queue.isClosed());
+}
+
+TEST(ThreadSafeMessageQueueTest, ClosedQueueDrainsRemainingItems) {
+    ThreadSafeMessageQueue<int> queue;
+    queue.push(1);
+    queue.close();
+    queue.push(2); // pushes are still accepted after close
+
+    int value = 0;
+    EXPECT_TRUE(queue.waitPop(value, chrono::seconds(1)));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(queue.waitPop(value, chrono::seconds(1)));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(queue.waitPop(value, chrono::seconds(1)));
+
+    queue.reopen();
+    EXPECT_FALSE(queue.isClosed());
+    EXPECT_FALSE(queue.waitPop(value, chrono::milliseconds(10)));
+}
+
+TEST(ThreadSafeMessageQueueTest, PushBatchKeepsOrder) {
+    ThreadSafeMessageQueue<int> queue;
+    vector<int> items = {1, 2, 3, 4, 5};
+    queue.pushBatch(items);
+    queue.push(6);
+
+    EXPECT_EQ(queue.size(), 6);
+    EXPECT_EQ(queue.popBatch(10), (vector<int>{1, 2, 3, 4, 5, 6}));
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "../include/WaitStrategy.h"
+#include "../include/ThreadSafeMessageQueue.h"
+#include "../include/SpscRingBuffer.h"
+
+#include <thread>
+#include <chrono>
+#include <vector>
+
+using namespace std;
+
+TEST(WaitStrategyTest, DefaultIsSpinThenPark) {
+    WaitStrategy strategy;
+    EXPECT_EQ(strategy.mode, WaitMode::SPIN_PARK);
+    EXPECT_EQ(to_string(WaitMode::BUSY_SPIN), "BUSY_SPIN");
+    EXPECT_EQ(to_string(WaitMode::SPIN_YIELD), "SPIN_YIELD");
+    EXPECT_EQ(to_string(WaitMode::SPIN_PARK), "SPIN_PARK");
+}
+
+TEST(WaitStrategyTest, EveryModePopsAvailableItem) {
+    for (const auto& strategy : {WaitStrategy::busySpin(), WaitStrategy::spinYield(), WaitStrategy::spinPark()}) {
+        ThreadSafeMessageQueue<int> queue;
+        queue.push(5);
+
+        int value = 0;
+        EXPECT_TRUE(strategy.waitPop(queue, value)) << to_string(strategy.mode);
+        EXPECT_EQ(value, 5);
+    }
+}
+
+TEST(WaitStrategyTest, SpinModesReturnWhenQueueStaysEmpty) {
+    SpscRingBuffer<int> queue(8);
+    int value = 0;
+
+    EXPECT_FALSE(WaitStrategy::busySpin(16).waitPop(queue, value));
+    EXPECT_FALSE(WaitStrategy::spinYield(16, 4).waitPop(queue, value));
+}
+
+TEST(WaitStrategyTest, ParkTimesOut) {
+    ThreadSafeMessageQueue<int> queue;
+    int value = 0;
+
+    auto start = chrono::steady_clock::now();
+    EXPECT_FALSE(WaitStrategy::spinPark(0, chrono::milliseconds(30)).waitPop(queue, value));
+    EXPECT_GE(chrono::steady_clock::now() - start, chrono::milliseconds(30));
+}
+
+TEST(WaitStrategyTest, ParkWakesOnPush) {
+    ThreadSafeMessageQueue<int> queue;
+
+    thread producer([&queue]() {
+        this_thread::sleep_for(chrono::milliseconds(30));
+        queue.push(9);
+    });
+
+    int value = 0;
+    EXPECT_TRUE(WaitStrategy::spinPark(8, chrono::seconds(10)).waitPop(queue, value));
+    EXPECT_EQ(value, 9);
+    producer.join();
+}
+
+TEST(WaitStrategyTest, ConsumerLoopReceivesEverythingInEveryMode) {
+    for (const auto& strategy : {WaitStrategy::busySpin(), WaitStrategy::spinYield(), WaitStrategy::spinPark()}) {
+        SpscRingBuffer<int> queue(64);
+        const int totalMessages = 5000;
+
+        thread producer([&queue]() {
+            for (int i = 0; i < totalMessages; ++i) queue.push(i);
+        });
+
+        vector<int> received;
+        int value = 0;
+        while (static_cast<int>(received.size()) < totalMessages) {
+            if (strategy.waitPop(queue, value)) received.push_back(value);
+        }
+        producer.join();
+
+        ASSERT_EQ(received.size(), totalMessages) << to_string(strategy.mode);
+        for (int i = 0; i < totalMessages; ++i) ASSERT_EQ(received[i], i);
+    }
+}
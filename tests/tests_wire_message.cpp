@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "../include/WireMarketDataMessage.h"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static MarketDataMessage makeMessage(const string& symbol, OrderSide side, const char* price, int quantity) {
+    return MarketDataMessage{
+        .symbol = symbol,
+        .side = side,
+        .price = Price::parse(price).value(),
+        .quantity = quantity,
+        .timestamp = chrono::system_clock::time_point(chrono::duration_cast<chrono::system_clock::duration>(chrono::nanoseconds(1633072800123456789)))
+    };
+}
+
+TEST(WireMarketDataMessageTest, RoundTripsThroughWireFormat) {
+    auto message = makeMessage("AAPL", OrderSide::SELL, "150.123456", 250);
+
+    auto wire = toWire(message, 42);
+    ASSERT_TRUE(wire.has_value());
+    EXPECT_EQ(wire->sequence, 42);
+    EXPECT_EQ(wire->symbolName(), "AAPL");
+    EXPECT_EQ(wire->price, 150123456);
+
+    auto back = fromWire(*wire);
+    ASSERT_TRUE(back.has_value());
+    EXPECT_EQ(back->symbol, message.symbol);
+    EXPECT_EQ(back->side, OrderSide::SELL);
+    EXPECT_EQ(back->price, message.price);
+    EXPECT_EQ(back->quantity, 250);
+    EXPECT_EQ(back->timestamp, message.timestamp);
+}
+
+TEST(WireMarketDataMessageTest, SurvivesRawByteCopies) {
+    vector<WireMarketDataMessage> written;
+    for (uint64_t i = 0; i < 8; ++i) {
+        written.push_back(toWire(makeMessage("BINANCE:BTCUSDT", OrderSide::BUY, "64000.5", static_cast<int>(i)), i).value());
+    }
+
+    // Stand-in for a file or shared memory segment
+    vector<unsigned char> bytes(written.size() * sizeof(WireMarketDataMessage));
+    memcpy(bytes.data(), written.data(), bytes.size());
+
+    vector<WireMarketDataMessage> read(written.size());
+    memcpy(read.data(), bytes.data(), bytes.size());
+
+    for (size_t i = 0; i < read.size(); ++i) {
+        auto message = fromWire(read[i]);
+        ASSERT_TRUE(message.has_value());
+        EXPECT_EQ(read[i].sequence, i);
+        EXPECT_EQ(message->symbol, "BINANCE:BTCUSDT");
+        EXPECT_EQ(message->quantity, static_cast<int>(i));
+    }
+}
+
+TEST(WireMarketDataMessageTest, RejectsWhatDoesNotFit) {
+    EXPECT_FALSE(toWire(makeMessage(string(WireMarketDataMessage::MAX_SYMBOL_LENGTH + 1, 'X'), OrderSide::BUY, "1", 1), 0).has_value());
+    EXPECT_TRUE(toWire(makeMessage(string(WireMarketDataMessage::MAX_SYMBOL_LENGTH, 'X'), OrderSide::BUY, "1", 1), 0).has_value());
+    EXPECT_FALSE(toWire(makeMessage("AAPL", OrderSide::BUY, "1", -5), 0).has_value());
+}
+
+TEST(WireMarketDataMessageTest, RejectsCorruptInput) {
+    auto wire = toWire(makeMessage("MSFT", OrderSide::BUY, "300", 10), 1).value();
+
+    auto badSide = wire;
+    badSide.side = 7;
+    EXPECT_FALSE(fromWire(badSide).has_value());
+
+    auto badLength = wire;
+    badLength.symbolLength = 200;
+    EXPECT_FALSE(fromWire(badLength).has_value());
+
+    auto badQuantity = wire;
+    badQuantity.quantity = 0xFFFFFFFFu;
+    EXPECT_FALSE(fromWire(badQuantity).has_value());
+}
+
+TEST(WireMarketDataMessageTest, KnownOnlyPolicyNeverInterns) {
+    auto wire = toWire(makeMessage("MSFT", OrderSide::BUY, "300", 10), 1).value();
+    auto known = fromWire(wire, WireSymbolPolicy::KNOWN_ONLY);
+    ASSERT_TRUE(known.has_value());
+    EXPECT_EQ(known->symbol, "MSFT");
+
+    const string unseen = "WIRE_UNSEEN_SYMBOL";
+    ASSERT_FALSE(SymbolTable::instance().find(unseen).has_value());
+    wire.symbolLength = static_cast<uint8_t>(unseen.size());
+    memcpy(wire.symbol, unseen.data(), unseen.size());
+
+    const size_t tableSize = SymbolTable::instance().size();
+    EXPECT_FALSE(fromWire(wire, WireSymbolPolicy::KNOWN_ONLY).has_value());
+    EXPECT_EQ(SymbolTable::instance().size(), tableSize);
+    EXPECT_FALSE(SymbolTable::instance().find(unseen).has_value());
+
+    // The default policy interns it
+    EXPECT_TRUE(fromWire(wire).has_value());
+    EXPECT_EQ(SymbolTable::instance().size(), tableSize + 1);
+}